@@ -2,21 +2,127 @@
 #define AIPLAYER_H
 
 #include "Board.h"
+#include "OpeningBook.h"
+#include "SearchLimits.h"
+#include "SearchStats.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
 
 /**
  * Abstract base class for AI players
  * Defines the interface that all AI implementations must follow
+ * @tparam BoardT The board variant the AI plays on
  */
-class AIPlayer {
+template <typename BoardT>
+class BasicAIPlayer {
 public:
-    virtual ~AIPlayer() = default;
+    virtual ~BasicAIPlayer() = default;
     
     /**
      * Select the best move for the current board state
      * @param board The current game board
-     * @return Column index (0-6) where the AI wants to place its piece
+     * @return Column index (0 to COLS - 1) where the AI wants to place its piece
      */
-    virtual int selectMove(const Board& board) = 0;
+    virtual int selectMove(const BoardT& board) = 0;
+    
+    /**
+     * Select the best move within a depth, time and/or node budget
+     * Engines that cannot honour a budget ignore it and search as usual.
+     * @param board The current game board
+     * @param limits Budget for this search
+     * @return Column index (0 to COLS - 1) where the AI wants to place its piece
+     */
+    virtual int selectMove(const BoardT& board, const SearchLimits& limits) {
+        (void)limits;
+        return selectMove(board);
+    }
+    
+    /**
+     * Select a move and report how the search went
+     * Engines without instrumentation only report the elapsed time and
+     * their chosen move.
+     * @param board The current game board
+     * @param limits Budget for this search
+     * @param stats Receives the search statistics (nullptr to skip collecting them)
+     * @return Column index (0 to COLS - 1) where the AI wants to place its piece
+     */
+    virtual int selectMove(const BoardT& board, const SearchLimits& limits, SearchStats* stats) {
+        if (!stats) {
+            return selectMove(board, limits);
+        }
+        
+        stats->reset();
+        auto start = std::chrono::steady_clock::now();
+        int move = selectMove(board, limits);
+        stats->elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (move >= 0) {
+            stats->principalVariation.push_back(move);
+        }
+        return move;
+    }
+    
+    /**
+     * Select a move for each position of a batch
+     * One call covers the whole batch, so engines can set up once, reuse
+     * their buffers, share what they learn between positions and search
+     * several positions at a time. Each position is searched as by
+     * selectMove, for this AI's pieces. The default searches them in turn.
+     * @param boards Positions to search
+     * @param moves Receives the move for each position (-1 if it has none)
+     * @param count Number of positions
+     * @param limits Budget for each position's search
+     */
+    virtual void selectMoves(const BoardT* boards, int* moves, std::size_t count, const SearchLimits& limits) {
+        for (std::size_t i = 0; i < count; i++) {
+            moves[i] = selectMove(boards[i], limits);
+        }
+    }
+    
+    /**
+     * Starts an independent game
+     * Engines forget what earlier searches cached and reseed their random
+     * choices, so the games that follow depend only on the seed and the
+     * positions searched. Engines without such state ignore it.
+     * @param seed Seed for the engine's random choices
+     */
+    virtual void newGame(std::uint32_t seed) {
+        (void)seed;
+    }
+    
+    /**
+     * Sets an opening book to play from before searching
+     * Engines that don't play from a book ignore it, and books only cover
+     * the standard board.
+     * @param book The book to share (nullptr removes the book)
+     */
+    void setOpeningBook(std::shared_ptr<const OpeningBook> book) {
+        openingBook = std::move(book);
+    }
+    
+protected:
+    std::shared_ptr<const OpeningBook> openingBook;
+    
+    /**
+     * Looks the position up in the opening book, if one is set
+     * @param board The current game board
+     * @param move Receives the book move on a hit
+     * @return True if the book has a move for this position
+     */
+    bool probeOpeningBook(const BoardT& board, int& move) const {
+        if constexpr (std::is_same<BoardT, Board>::value) {
+            int score;
+            return openingBook && openingBook->probe(board, move, score);
+        } else {
+            (void)board;
+            (void)move;
+            return false;
+        }
+    }
 };
 
+using AIPlayer = BasicAIPlayer<Board>;
+
 #endif // AIPLAYER_H
@@ -0,0 +1,68 @@
+#ifndef BITUTILS_H
+#define BITUTILS_H
+
+#include <cstdint>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+/**
+ * Number of set bits in a bitboard
+ */
+inline int popcount64(std::uint64_t bits) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    return static_cast<int>(__popcnt64(bits));
+#elif defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(bits);
+#else
+    int count = 0;
+    while (bits) {
+        bits &= bits - 1;
+        count++;
+    }
+    return count;
+#endif
+}
+
+/**
+ * Index of the highest set bit of a non-zero bitboard
+ */
+inline int highestBit64(std::uint64_t bits) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanReverse64(&index, bits);
+    return static_cast<int>(index);
+#elif defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(bits);
+#else
+    int index = 0;
+    while (bits >>= 1) {
+        index++;
+    }
+    return index;
+#endif
+}
+
+/**
+ * Reads 8 bytes stored least significant first, as the book, record and
+ * wire formats do
+ */
+inline std::uint64_t readLittleEndian64(const unsigned char* bytes) {
+    std::uint64_t value = 0;
+    for (int i = 7; i >= 0; i--) {
+        value = (value << 8) | bytes[i];
+    }
+    return value;
+}
+
+/**
+ * Writes a value as 8 bytes, least significant first
+ */
+inline void writeLittleEndian64(unsigned char* bytes, std::uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        bytes[i] = static_cast<unsigned char>(value >> (8 * i));
+    }
+}
+
+#endif // BITUTILS_H
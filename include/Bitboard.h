@@ -0,0 +1,139 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include "BitUtils.h"
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * 128-bit bitboard for boards whose column-major layout doesn't fit in 64
+ * bits (e.g. 9 columns of 7 rows plus sentinels). Provides just the integer
+ * operations the bitboard code uses, so templated code can treat it like
+ * std::uint64_t. Portable, unlike compiler-specific 128-bit integers.
+ */
+struct Bitboard128 {
+    std::uint64_t lo;
+    std::uint64_t hi;
+
+    constexpr Bitboard128(std::uint64_t low = 0, std::uint64_t high = 0) : lo(low), hi(high) {}
+
+    constexpr explicit operator bool() const {
+        return (lo | hi) != 0;
+    }
+
+    constexpr Bitboard128 operator~() const {
+        return Bitboard128(~lo, ~hi);
+    }
+
+    constexpr Bitboard128 operator<<(int shift) const {
+        if (shift == 0) {
+            return *this;
+        }
+        if (shift >= 128) {
+            return Bitboard128();
+        }
+        if (shift >= 64) {
+            return Bitboard128(0, lo << (shift - 64));
+        }
+        return Bitboard128(lo << shift, (hi << shift) | (lo >> (64 - shift)));
+    }
+
+    constexpr Bitboard128 operator>>(int shift) const {
+        if (shift == 0) {
+            return *this;
+        }
+        if (shift >= 128) {
+            return Bitboard128();
+        }
+        if (shift >= 64) {
+            return Bitboard128(hi >> (shift - 64), 0);
+        }
+        return Bitboard128((lo >> shift) | (hi << (64 - shift)), hi >> shift);
+    }
+
+    constexpr Bitboard128 operator+(const Bitboard128& other) const {
+        std::uint64_t low = lo + other.lo;
+        return Bitboard128(low, hi + other.hi + (low < lo ? 1 : 0));
+    }
+
+    constexpr Bitboard128 operator-(const Bitboard128& other) const {
+        return Bitboard128(lo - other.lo, hi - other.hi - (lo < other.lo ? 1 : 0));
+    }
+
+    constexpr Bitboard128 operator&(const Bitboard128& other) const {
+        return Bitboard128(lo & other.lo, hi & other.hi);
+    }
+
+    constexpr Bitboard128 operator|(const Bitboard128& other) const {
+        return Bitboard128(lo | other.lo, hi | other.hi);
+    }
+
+    constexpr Bitboard128 operator^(const Bitboard128& other) const {
+        return Bitboard128(lo ^ other.lo, hi ^ other.hi);
+    }
+
+    constexpr Bitboard128& operator<<=(int shift) {
+        return *this = *this << shift;
+    }
+
+    constexpr Bitboard128& operator>>=(int shift) {
+        return *this = *this >> shift;
+    }
+
+    constexpr Bitboard128& operator&=(const Bitboard128& other) {
+        return *this = *this & other;
+    }
+
+    constexpr Bitboard128& operator|=(const Bitboard128& other) {
+        return *this = *this | other;
+    }
+
+    constexpr Bitboard128& operator^=(const Bitboard128& other) {
+        return *this = *this ^ other;
+    }
+
+    constexpr bool operator==(const Bitboard128& other) const {
+        return lo == other.lo && hi == other.hi;
+    }
+
+    constexpr bool operator!=(const Bitboard128& other) const {
+        return !(*this == other);
+    }
+
+    constexpr bool operator<(const Bitboard128& other) const {
+        return hi < other.hi || (hi == other.hi && lo < other.lo);
+    }
+};
+
+/**
+ * Smallest bitboard type holding the given number of bits (at most 128)
+ */
+template <int Bits>
+using BitboardFor = typename std::conditional<(Bits <= 64), std::uint64_t, Bitboard128>::type;
+
+/**
+ * Number of set bits in a bitboard of either width
+ */
+inline int popcount(std::uint64_t bits) {
+    return popcount64(bits);
+}
+
+inline int popcount(const Bitboard128& bits) {
+    return popcount64(bits.lo) + popcount64(bits.hi);
+}
+
+/**
+ * Mixes a position key into 64 bits for hash tables. Keys of up to 63 bits
+ * are better used as they are, since they are exact; wider keys can
+ * collide after hashing, like any 64-bit hash key.
+ */
+inline std::uint64_t hashKey(std::uint64_t key) {
+    // Multiplying by an odd constant is a bijection, so no information is lost
+    return key * 0x9E3779B97F4A7C15ULL;
+}
+
+inline std::uint64_t hashKey(const Bitboard128& key) {
+    return (key.lo ^ (key.hi * 0xC2B2AE3D27D4EB4FULL)) * 0x9E3779B97F4A7C15ULL;
+}
+
+#endif // BITBOARD_H
@@ -1,31 +1,195 @@
 #ifndef BOARD_H
 #define BOARD_H
 
-#include <vector>
+#include "Bitboard.h"
+#include <cstdint>
 
-class Board {
+// Upper bound on the cells of any board variant: the bitboards, including
+// one sentinel bit per column, hold at most 128 bits
+const int MAX_BOARD_CELLS = 128;
+
+/**
+ * Connect-K board of any size, fixed at compile time
+ * Rows and columns are counted as on screen; the game is won by K pieces in
+ * a row. Everything derived from the dimensions (bitboard type, masks, line
+ * shifts) is a compile-time constant, so each variant gets its own fully
+ * specialized code. The library instantiates the variants aliased below.
+ */
+template <int Rows, int Cols, int K>
+class BasicBoard {
 public:
-    static const int ROWS = 6;
-    static const int COLS = 7;
-    
-    Board();
-    
-    bool dropPiece(int column, char player);
+    static constexpr int ROWS = Rows;
+    static constexpr int COLS = Cols;
+    static constexpr int CONNECT = K;
+
+    // Bits per column: ROWS cells plus a sentinel
+    static constexpr int COLUMN_BITS = Rows + 1;
+
+    // Bits spanned by a position key (see getKey)
+    static constexpr int KEY_BITS = Cols * COLUMN_BITS;
+
+    // Number of K-cell lines that fit on the board (69 on the standard board)
+    static constexpr int WINDOW_COUNT =
+        Rows * (Cols >= K ? Cols - K + 1 : 0) +
+        Cols * (Rows >= K ? Rows - K + 1 : 0) +
+        2 * (Rows >= K ? Rows - K + 1 : 0) * (Cols >= K ? Cols - K + 1 : 0);
+
+    static_assert(Rows > 0 && Cols > 0 && KEY_BITS <= MAX_BOARD_CELLS,
+                  "Bitboards hold at most 128 bits, sentinels included");
+    static_assert(K >= 2 && (K <= Rows || K <= Cols), "The board must have room for a winning line");
+    static_assert(Cols <= 127, "Moves must fit in a signed byte");
+
+    using Bitboard = BitboardFor<KEY_BITS>;
+
+    BasicBoard();
+
+    /**
+     * Rebuilds a position from its bitboards, e.g. one stored compactly
+     * Heights and move count follow from the pieces. Of the move history
+     * only the last move is known: getMove returns -1 and undoMove fails
+     * for the moves before it.
+     * @param xMask Bitboard of X's pieces (see getPlayerMask)
+     * @param oMask Bitboard of O's pieces
+     * @param lastColumn Column of the most recent move (-1 on an empty board)
+     */
+    static BasicBoard fromMasks(Bitboard xMask, Bitboard oMask, int lastColumn);
+
+    /**
+     * RAII helper for make/unmake search: drops a piece on construction and
+     * takes it back out of the same column when the guard goes out of scope.
+     * Lets a search walk the tree on a single Board instead of copying it.
+     */
+    class MoveGuard {
+    public:
+        MoveGuard(BasicBoard& board, int column, char player);
+        ~MoveGuard();
+
+        MoveGuard(const MoveGuard&) = delete;
+        MoveGuard& operator=(const MoveGuard&) = delete;
+
+        // False if the drop was rejected (full or invalid column)
+        bool applied() const;
+
+    private:
+        BasicBoard& board;
+        int column;
+        bool dropped;
+    };
+
+    /**
+     * Drops a piece into a column
+     * @param landingRow If non-null, receives the row the piece landed in
+     * @return False if the column is full or invalid
+     */
+    bool dropPiece(int column, char player, int* landingRow = nullptr);
+
+    /**
+     * Takes back the most recent move, which must have been played in column
+     * @return False if column does not hold the most recent move
+     */
+    bool undoMove(int column);
+
     bool checkWin(char player) const;
+
+    /**
+     * Checks whether the most recently dropped piece completed a line.
+     * Equivalent to checkWin for whoever moved last, without naming the
+     * player, as long as the position had no winner before that move.
+     */
+    bool lastMoveWins() const;
+
     bool isFull() const;
     void display() const;
     void reset();
-    
+
     // Query methods for UI
     char getCell(int row, int col) const;
     bool isColumnFull(int column) const;
-    
+    int getColumnHeight(int column) const;
+    int getMoveCount() const;
+
+    /**
+     * @param ply Index of a move played so far (0 is the first move)
+     * @return Column of that move, or -1 if ply is out of range or the
+     *         move isn't known (see fromMasks)
+     */
+    int getMove(int ply) const;
+
+    // Bitboard access for AI engines
+    Bitboard getPlayerMask(char player) const;
+    Bitboard getOccupiedMask() const;
+
+    /**
+     * Unique key for the current position, derived in O(1) from the
+     * bitboards (X's pieces plus one marker bit above each column's stack).
+     * Suitable for transposition tables and position lookups; KEY_BITS wide.
+     */
+    Bitboard getKey() const;
+
+    /**
+     * One bit at the bottom of every column
+     */
+    static constexpr Bitboard bottomMask() {
+        Bitboard mask = 0;
+        for (int col = 0; col < Cols; col++) {
+            mask |= Bitboard(1) << (col * COLUMN_BITS);
+        }
+        return mask;
+    }
+
+    /**
+     * Every playable cell, sentinels excluded
+     */
+    static constexpr Bitboard boardMask() {
+        Bitboard mask = 0;
+        for (int col = 0; col < Cols; col++) {
+            mask |= columnMask(col);
+        }
+        return mask;
+    }
+
+    /**
+     * The playable cells of one column
+     */
+    static constexpr Bitboard columnMask(int col) {
+        return ((Bitboard(1) << Rows) - Bitboard(1)) << (col * COLUMN_BITS);
+    }
+
+    /**
+     * The i-th column when walking outwards from the center, the order the
+     * engines try moves in: 3, 2, 4, 1, 5, 0, 6 on the standard board
+     */
+    static constexpr int centerOutColumn(int i) {
+        return (i % 2 == 1) ? Cols / 2 - (i + 1) / 2 : Cols / 2 + i / 2;
+    }
+
 private:
-    std::vector<std::vector<char>> grid;
-    
-    bool checkDirection(int row, int col, int dRow, int dCol, char player) const;
+    /**
+     * Column-major bitboards, one per player ('X' and 'O').
+     * Bit (col * (ROWS + 1) + h) is set when the cell h rows above the
+     * bottom of column col holds that player's piece. The extra bit on top
+     * of each column is always clear so shifts never bleed across columns.
+     */
+    Bitboard pieces[2];
+    std::uint8_t heights[Cols];
+    std::uint8_t moveHistory[Rows * Cols]; // UNKNOWN_MOVE where fromMasks had no history
+    std::uint8_t moveCount;
+
+    static constexpr std::uint8_t UNKNOWN_MOVE = 0xFF;
+
+    static int playerIndex(char player);
+    static Bitboard cellBit(int row, int col);
+    static bool hasLine(Bitboard bits);
     bool isValidColumn(int column) const;
     int getNextAvailableRow(int column) const;
 };
 
+// Standard Connect 4: 7 columns, 6 rows
+using Board = BasicBoard<6, 7, 4>;
+
+// Variants used in leagues; the engines are instantiated for these as well
+using Board8x7 = BasicBoard<7, 8, 4>;
+using Board9x7 = BasicBoard<7, 9, 4>; // 128-bit bitboards
+using Board9x6Connect5 = BasicBoard<6, 9, 5>;
+
 #endif // BOARD_H
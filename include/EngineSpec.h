@@ -0,0 +1,52 @@
+#ifndef ENGINESPEC_H
+#define ENGINESPEC_H
+
+#include "AIPlayer.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/**
+ * AI player configuration given as short text, as used by the command-line
+ * tools:
+ *   random          RandomAI
+ *   minimax[:D]     MinimaxAI searching to depth D (default 4)
+ *   solver          SolverAI
+ */
+struct EngineSpec {
+    enum class Kind {
+        RANDOM,
+        MINIMAX,
+        SOLVER
+    };
+
+    Kind kind = Kind::MINIMAX;
+    int depth = 4;
+
+    /**
+     * Parses a spec string
+     * @param text Spec such as "minimax:6"
+     * @param spec Receives the parsed configuration
+     * @return False if the text isn't a valid spec
+     */
+    static bool parse(const std::string& text, EngineSpec& spec);
+
+    /**
+     * @return Canonical text form of the spec, e.g. "minimax:6"
+     */
+    std::string toString() const;
+
+    /**
+     * Creates an AI player for this configuration
+     * @param player Character the engine plays ('X' or 'O')
+     * @param ttSizeMB Transposition table size for searching engines
+     * @param seed Random seed for RandomAI
+     * @tparam BoardT Board variant to play on (instantiated for the variants in Board.h)
+     * @return The new AI player
+     */
+    template <typename BoardT = Board>
+    std::unique_ptr<BasicAIPlayer<BoardT>> create(char player, std::size_t ttSizeMB, std::uint32_t seed) const;
+};
+
+#endif // ENGINESPEC_H
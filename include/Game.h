@@ -3,7 +3,13 @@
 
 #include "Board.h"
 #include "AIPlayer.h"
+#include "GameState.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <future>
 #include <memory>
+#include <string>
 
 enum class GameMode {
     PLAYER_VS_PLAYER,
@@ -13,17 +19,25 @@ enum class GameMode {
 enum class AIDifficulty {
     EASY,    // Random AI
     MEDIUM,  // Minimax depth 4
-    HARD     // Minimax depth 6
+    HARD,    // Minimax depth 6
+    PERFECT  // Exact solver
 };
 
 class Game {
 public:
     Game();
+    ~Game();
     
     // Game configuration
     void setGameMode(GameMode mode);
     void setAIDifficulty(AIDifficulty difficulty);
     void setMinimaxDepth(int depth);
+    void setTranspositionTableSize(std::size_t megabytes);
+    void setSearchLimits(const SearchLimits& limits);
+    void setSearchThreads(int threads);
+    bool setOpeningBook(const std::string& path);
+    void setCollectSearchStats(bool enabled);
+    const SearchStats& getLastSearchStats() const;
     GameMode getGameMode() const;
     bool isAITurn() const;
     
@@ -39,25 +53,63 @@ public:
     int getAIMove();
     void makeAIMove();
     
+    // Background AI search, so a UI can keep drawing while the AI thinks
+    bool beginAIMove();   // Starts searching a copy of the board; false if not the AI's turn
+    bool pollAIMove();    // Plays the AI's move if the search has finished; true if it did
+    void cancelAIMove();  // Stops a running search and discards its move
+    bool isAIThinking() const;
+    
+    // Pondering: while the human decides, search the AI's reply to each of
+    // their possible moves so the real reply is ready when they move
+    bool startPondering(); // False if it isn't the human's turn against the AI
+    void stopPondering();  // Called by makeMove, so dropping a piece cancels it
+    bool isPondering() const;
+    
     // Console-specific methods (kept for backward compatibility)
     void start();
     void playTurn();
     void displayWinner() const;
     
 private:
-    Board board;
-    char currentPlayer;
-    bool gameOver;
-    char winner;
+    GameState state;
     
     // AI configuration
     GameMode gameMode;
     AIDifficulty aiDifficulty;
     int minimaxDepth;
+    std::size_t ttSizeMB;
+    SearchLimits searchLimits;
+    int searchThreads;
+    std::shared_ptr<const OpeningBook> openingBook;
+    bool collectSearchStats;
+    SearchStats lastSearchStats;
     std::unique_ptr<AIPlayer> aiPlayer;
     char aiPlayerChar; // 'O' for Player 2 by default
     
-    void switchPlayer();
+    // Search started by beginAIMove; only that thread touches aiPlayer until
+    // the future has been collected
+    std::future<int> pendingAIMove;
+    std::atomic<bool> stopAIMove;
+    SearchStats pendingSearchStats;
+    
+    // AI reply found by pondering, keyed by the position after the human's move
+    struct PonderedReply {
+        std::uint64_t key = 0;
+        int move = -1;
+        SearchStats stats;
+    };
+    
+    // Pondering runs on its own thread and owns aiPlayer and ponderedReplies
+    // until stopPondering has collected it
+    std::future<void> pondering;
+    std::atomic<bool> stopPonder;
+    PonderedReply ponderedReplies[Board::COLS];
+    
+    SearchLimits moveLimits() const; // searchLimits, with a default budget for the solver
+    void ponder(Board position, SearchLimits limits, bool collectStats);
+    bool takePonderedReply(int& move);
+    void clearPonderedReplies();
+    
     int getPlayerMove() const;
     void initializeAI();
 };
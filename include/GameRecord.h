@@ -0,0 +1,200 @@
+#ifndef GAMERECORD_H
+#define GAMERECORD_H
+
+#include "Board.h"
+#include "MappedFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/**
+ * One game of a game record file
+ * Points straight into the memory-mapped file, so reading a game copies
+ * nothing; the record stays valid while its reader has the file open.
+ *
+ * Games are stored as move sequences with as few bits per move as the
+ * column count needs (3 on the standard board), so a typical game takes
+ * about ten bytes. File layout (all integers little-endian):
+ *   16-byte header: "C4GR", version, rows, cols, connect length, game count (64-bit)
+ *   records, back to back: move count (1 byte), result (1 byte), then the
+ *   moves packed from the lowest bit of the first byte up, padded to a whole byte
+ * The result is the winner ('X' or 'O'), ' ' for a draw or '?' for a game
+ * that didn't finish.
+ */
+struct GameRecord {
+    static const std::uint8_t FORMAT_VERSION = 1;
+
+    const unsigned char* packedMoves = nullptr;
+    int moveCount = 0;
+    int moveBits = 0;
+    char result = '?';
+
+    /**
+     * @param ply Index of the move (0 is the first move)
+     * @return Column of that move
+     */
+    int getMove(int ply) const {
+        int bit = ply * moveBits;
+        unsigned value = packedMoves[bit / 8];
+        if (bit % 8 + moveBits > 8) {
+            value |= static_cast<unsigned>(packedMoves[bit / 8 + 1]) << 8;
+        }
+        return static_cast<int>((value >> (bit % 8)) & ((1u << moveBits) - 1));
+    }
+
+    /**
+     * Plays the game's moves onto a board
+     * @param board Board to play on, normally empty
+     * @param plies Number of moves to play (-1 for the whole game)
+     * @return False if a move was illegal on this board
+     */
+    template <typename BoardT>
+    bool replay(BoardT& board, int plies = -1) const {
+        int count = (plies < 0 || plies > moveCount) ? moveCount : plies;
+        for (int ply = 0; ply < count; ply++) {
+            char player = (board.getMoveCount() % 2 == 0) ? 'X' : 'O';
+            if (!board.dropPiece(getMove(ply), player)) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+/**
+ * Streams games into a game record file (see GameRecord for the format)
+ * Records are buffered and written in large blocks; the game count in the
+ * header is filled in by close().
+ */
+class GameRecordWriter {
+public:
+    GameRecordWriter();
+
+    /**
+     * Closes the file, if still open
+     */
+    ~GameRecordWriter();
+
+    GameRecordWriter(const GameRecordWriter&) = delete;
+    GameRecordWriter& operator=(const GameRecordWriter&) = delete;
+
+    /**
+     * Creates a record file for games on the given board, replacing any
+     * existing file
+     * @return False if the file can't be created or the board is too large
+     */
+    bool open(const std::string& path, int rows, int cols, int connect);
+
+    template <typename BoardT>
+    bool open(const std::string& path) {
+        return open(path, BoardT::ROWS, BoardT::COLS, BoardT::CONNECT);
+    }
+
+    /**
+     * Appends a game
+     * @param moves Columns played, first move first
+     * @param moveCount Number of moves
+     * @param result 'X' or 'O' for the winner, ' ' for a draw, '?' if unfinished
+     * @return False if the file isn't open, a move is out of range or
+     *         writing failed
+     */
+    bool write(const int* moves, int moveCount, char result);
+
+    /**
+     * Appends the game played on a board so far
+     */
+    template <typename BoardT>
+    bool write(const BoardT& board, char result) {
+        int moves[MAX_BOARD_CELLS];
+        int moveCount = board.getMoveCount();
+        for (int ply = 0; ply < moveCount; ply++) {
+            moves[ply] = board.getMove(ply);
+        }
+        return write(moves, moveCount, result);
+    }
+
+    /**
+     * Writes out buffered games and the final game count
+     * @return False if anything failed to write since the file was opened
+     */
+    bool close();
+
+    bool isOpen() const;
+
+    /**
+     * @return Number of games written so far
+     */
+    std::uint64_t size() const;
+
+private:
+    std::ofstream out;
+    std::vector<unsigned char> buffer;
+    std::uint64_t gameCount;
+    int cols;
+    int cells;
+    int moveBits;
+
+    bool flush();
+};
+
+/**
+ * Reads a game record file through a memory mapping
+ * Games are read in order with next(); each read only decodes the two-byte
+ * record header, and moves are unpacked on demand.
+ */
+class GameRecordReader {
+public:
+    GameRecordReader();
+
+    /**
+     * Maps a record file and checks its header
+     * @param path Path of the record file
+     * @return False if the file is missing or malformed
+     */
+    bool open(const std::string& path);
+
+    void close();
+    bool isOpen() const;
+
+    /**
+     * @return Number of games according to the header
+     */
+    std::uint64_t size() const;
+
+    int getRows() const;
+    int getCols() const;
+    int getConnect() const;
+
+    /**
+     * @return True if the games were played on the board variant BoardT
+     */
+    template <typename BoardT>
+    bool isFor() const {
+        return rows == BoardT::ROWS && cols == BoardT::COLS && connect == BoardT::CONNECT;
+    }
+
+    /**
+     * Reads the next game
+     * @param record Receives the game on success
+     * @return False at the end of the file or at a truncated or invalid record
+     */
+    bool next(GameRecord& record);
+
+    /**
+     * Starts reading from the first game again
+     */
+    void rewind();
+
+private:
+    MappedFile file;
+    std::size_t offset;
+    std::uint64_t gameCount;
+    int rows;
+    int cols;
+    int connect;
+    int moveBits;
+};
+
+#endif // GAMERECORD_H
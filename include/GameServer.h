@@ -0,0 +1,161 @@
+#ifndef GAMESERVER_H
+#define GAMESERVER_H
+
+#include "EngineSpec.h"
+#include "SearchLimits.h"
+#include "SessionPool.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Capacity and AI resources of a GameServer
+ */
+struct GameServerConfig {
+    std::size_t maxSessions = 16384;
+    int aiThreads = 0;        // 0 = one per hardware thread
+    std::size_t ttSizeMB = 4; // Per engine; each worker has one engine per kind and color
+    SearchLimits limits;      // Time and node budget per AI move (depth comes from the engine spec)
+};
+
+/**
+ * Headless host for many concurrent games
+ * Sessions live in a SessionPool owned by the calling thread; AI moves are
+ * searched by a fixed set of worker threads, each with its own engines, so
+ * memory is bounded by the session capacity plus one set of transposition
+ * tables per worker, however many games are running.
+ *
+ * Every method must be called from the thread that owns the server. An AI
+ * search works on a copy of the board and its result is only applied by
+ * pollAIMoves, so sessions are never touched by the workers.
+ */
+class GameServer {
+public:
+    /**
+     * An AI move that has been played, or a failed one
+     * column is NO_MOVE when the engine returned no legal move; that session
+     * is left as it was, with no AI move pending, and should be closed.
+     */
+    struct AIMove {
+        SessionHandle session;
+        int column;
+    };
+
+    static const int NO_MOVE = -1;
+
+    explicit GameServer(const GameServerConfig& config = GameServerConfig());
+
+    /**
+     * Stops the workers, abandoning the searches in progress; AI moves
+     * still queued are dropped
+     */
+    ~GameServer();
+
+    GameServer(const GameServer&) = delete;
+    GameServer& operator=(const GameServer&) = delete;
+
+    /**
+     * Opens a game; if the AI plays 'X' its first move is requested at once
+     * @param engine The AI opponent
+     * @param aiPlayer 'X' or 'O' for the AI's pieces, ' ' for two human players
+     * @return The new session, or an invalid handle if the server is full
+     */
+    SessionHandle createSession(const EngineSpec& engine, char aiPlayer);
+
+    /**
+     * Closes a game; a pending AI move for it is dropped from the queue or,
+     * if it is being searched, the search is stopped
+     * @return False if the session doesn't exist
+     */
+    bool closeSession(SessionHandle session);
+
+    /**
+     * @return The session, or nullptr if it doesn't exist
+     */
+    const GameSession* getSession(SessionHandle session) const;
+
+    /**
+     * Plays a human move and, if the AI is to move next, queues its reply
+     * @return False if the session doesn't exist, it is the AI's turn or
+     *         the move is illegal
+     */
+    bool makeMove(SessionHandle session, int column);
+
+    /**
+     * Applies the AI moves finished since the last call
+     * @param applied Cleared, then receives the moves played and the
+     *        failed ones (column NO_MOVE)
+     * @return Number of entries in applied
+     */
+    std::size_t pollAIMoves(std::vector<AIMove>& applied);
+
+    /**
+     * Sets a function called on a worker thread whenever an AI move is
+     * ready for pollAIMoves, e.g. to wake up an event loop. Set it before
+     * creating sessions.
+     */
+    void setAIMoveNotifier(std::function<void()> notifier);
+
+    /**
+     * @return Number of open sessions
+     */
+    std::size_t sessionCount() const;
+
+    /**
+     * @return Number of AI moves requested and not yet applied
+     */
+    std::size_t pendingAIMoveCount() const;
+
+    /**
+     * @return Number of AI worker threads
+     */
+    int workerCount() const;
+
+private:
+    // Everything a worker needs to search, copied out of the session
+    struct AIRequest {
+        SessionHandle session;
+        Board board;
+        EngineSpec engine;
+        char player;
+    };
+
+    struct AIResult {
+        SessionHandle session;
+        int moveCount; // Pieces on the board the move was searched for
+        int column;
+    };
+
+    // The request a worker is searching, so it can be stopped from outside
+    struct ActiveSearch {
+        SessionHandle session;          // Guarded by requestMutex; invalid while idle
+        std::atomic<bool> stop{false}; // Passed to the search as SearchLimits::stop
+    };
+
+    GameServerConfig config;
+    SessionPool sessions;
+    std::size_t pendingMoves;
+    std::function<void()> notifier;
+
+    std::vector<std::thread> workers;
+    std::unique_ptr<ActiveSearch[]> activeSearches; // One per worker
+    std::deque<AIRequest> requests;
+    std::mutex requestMutex;
+    std::condition_variable requestAvailable;
+    bool stopping;
+
+    std::vector<AIResult> results;
+    std::vector<AIResult> collected; // Scratch for pollAIMoves
+    std::mutex resultMutex;
+
+    void requestAIMove(SessionHandle handle, GameSession& session);
+    void workerLoop(int index);
+};
+
+#endif // GAMESERVER_H
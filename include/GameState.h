@@ -0,0 +1,86 @@
+#ifndef GAMESTATE_H
+#define GAMESTATE_H
+
+#include "Board.h"
+#include <cstdint>
+
+/**
+ * Rules of a single game without any players attached: the board, whose
+ * turn it is and how the game ended
+ * Shared by Game and by GameServer, which stores its sessions as a
+ * PackedGameState and plays moves on the unpacked state.
+ */
+class GameState {
+public:
+    GameState();
+
+    /**
+     * Drops a piece for the player to move and ends the game on a line of
+     * four or a full board; otherwise passes the turn
+     * @param column Column to play (0 to COLS - 1)
+     * @return False if the game is over or the column is full or invalid
+     */
+    bool makeMove(int column);
+
+    void reset();
+    char getCurrentPlayer() const;
+    bool isGameOver() const;
+
+    /**
+     * @return 'X' or 'O' once that player has won, otherwise ' '
+     */
+    char getWinner() const;
+
+    const Board& getBoard() const;
+
+private:
+    friend class PackedGameState;
+
+    Board board;
+    char currentPlayer;
+    bool gameOver;
+    char winner;
+};
+
+/**
+ * A GameState packed into 24 bytes for hosting many games: the two
+ * bitboards, the move count, the last move and whose turn it is or how the
+ * game ended. The move history isn't kept, so a state unpacked from it only
+ * knows the last move (see Board::fromMasks); play and search need no more.
+ */
+class PackedGameState {
+public:
+    /**
+     * A new game
+     */
+    PackedGameState();
+
+    explicit PackedGameState(const GameState& state);
+
+    /**
+     * @return The game as a GameState, to play moves or search it
+     */
+    GameState unpack() const;
+
+    Board::Bitboard getPlayerMask(char player) const;
+    int getMoveCount() const;
+
+    /**
+     * @return Column of the most recent move, or -1 on an empty board
+     */
+    int getLastMove() const;
+
+    char getCurrentPlayer() const;
+    bool isGameOver() const;
+    char getWinner() const;
+
+private:
+    Board::Bitboard pieces[2];
+    std::uint8_t moveCount;
+    std::int8_t lastMove;
+    char currentPlayer;
+    bool gameOver;
+    char winner;
+};
+
+#endif // GAMESTATE_H
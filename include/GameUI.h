@@ -4,6 +4,8 @@
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
 #include "Game.h"
+#include <string>
+#include <unordered_map>
 
 enum class UIState {
     MODE_SELECTION,
@@ -19,17 +21,43 @@ public:
     void run();
     void cleanup();
     
+    // Opening book used by the AI opponents; false if it can't be opened
+    bool loadOpeningBook(const std::string& path);
+    
+    // Redraw every frame at ~60 FPS instead of only when something changed
+    void setContinuousRendering(bool enabled);
+    
 private:
     // SDL components
     SDL_Window* window;
     SDL_Renderer* renderer;
     TTF_Font* font;
     
+    // Textures rendered once and reused every frame
+    struct TextTexture {
+        SDL_Texture* texture;
+        int width;
+        int height;
+        std::string text; // Checked on lookup, as different texts may share a key
+        Uint32 color;     // Packed RGBA
+    };
+    SDL_Texture* circleTexture; // White disc of PIECE_RADIUS, tinted when drawn
+    std::unordered_map<Uint64, TextTexture> textCache; // Keyed by a hash of the text and color
+    
     // Game state
     Game game;
     int hoveredColumn;
     bool showWinMessage;
     UIState uiState;
+    Uint32 aiTurnStart; // When the running AI search started, in SDL ticks
+    int thinkingDots;   // Dots shown after "is thinking" in the last frame
+    
+    // Rendering state: by default a frame is drawn only when needsRedraw is set
+    bool needsRedraw;
+    bool continuousRendering;
+    bool showFrameStats; // Overlay toggled with F3
+    Uint32 redrawCount;
+    double lastFrameMs;
     
     // Mode selection state
     GameMode selectedGameMode;
@@ -45,6 +73,10 @@ private:
     static const int PIECE_RADIUS = 35;
     static const int BUTTON_WIDTH = 150;
     static const int BUTTON_HEIGHT = 50;
+    static const Uint32 AI_MOVE_DELAY_MS = 500; // Minimum time before an AI move appears
+    static const std::size_t MAX_CACHED_TEXTS = 128; // The cache starts over beyond this
+    static const int IDLE_WAIT_MS = 500;     // Longest sleep between events when nothing changes
+    static const int THINKING_WAIT_MS = 15;  // Sleep between checks for the AI's move
     
     // Helper methods
     void handleEvents(bool& running);
@@ -57,9 +89,11 @@ private:
     void renderPlayerTurn();
     void renderWinMessage();
     void renderButtons();
+    void renderFrameStats();
     
     void handleModeSelectionClick(int mouseX, int mouseY);
     int getColumnFromMouseX(int mouseX);
+    int getThinkingDots() const;
     bool isMouseOverNewGameButton(int mouseX, int mouseY);
     bool isMouseOverQuitButton(int mouseX, int mouseY);
     bool isMouseOverBackButton(int mouseX, int mouseY);
@@ -70,6 +104,7 @@ private:
     bool isMouseOverEasyButton(int mouseX, int mouseY);
     bool isMouseOverMediumButton(int mouseX, int mouseY);
     bool isMouseOverHardButton(int mouseX, int mouseY);
+    bool isMouseOverPerfectButton(int mouseX, int mouseY);
     bool isMouseOverStartButton(int mouseX, int mouseY);
     bool isMouseOverDepthSlider(int mouseX, int mouseY);
     void updateDepthFromMouse(int mouseX);
@@ -77,6 +112,12 @@ private:
     void drawFilledCircle(int centerX, int centerY, int radius, SDL_Color color);
     void drawButton(int x, int y, int width, int height, const char* text, SDL_Color bgColor);
     void renderText(const char* text, int x, int y, SDL_Color color);
+    void renderUncachedText(const char* text, int x, int y, SDL_Color color);
+    
+    // Texture cache helpers
+    void createCircleTexture();
+    const TextTexture* getTextTexture(const char* text, SDL_Color color);
+    void clearTextureCache();
 };
 
 #endif // GAMEUI_H
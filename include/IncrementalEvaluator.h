@@ -0,0 +1,108 @@
+#ifndef INCREMENTALEVALUATOR_H
+#define INCREMENTALEVALUATOR_H
+
+#include "Board.h"
+#include <cstdint>
+
+/**
+ * Search-side shadow of a Board that keeps MinimaxAI's heuristic score up to
+ * date as pieces are dropped and taken back
+ * Stores the number of AI and opponent pieces in each of the K-cell windows
+ * (69 on the standard board) together with the running total, so a drop
+ * only re-scores the windows through the new piece (at most 13 for K = 4)
+ * and reading the score is O(1).
+ * Scores match MinimaxAI::evaluateBoard exactly.
+ * @tparam BoardT The board variant to mirror
+ */
+template <typename BoardT>
+class BasicIncrementalEvaluator {
+public:
+    static const int WINDOW_COUNT = BoardT::WINDOW_COUNT;
+
+    static_assert(WINDOW_COUNT <= 256, "Window indices must fit in a byte");
+    static_assert(BoardT::CONNECT * (BoardT::CONNECT + 2) < 256, "Window states must fit in a byte");
+
+    /**
+     * RAII helper mirroring Board::MoveGuard: records a drop on construction
+     * and reverts it when the guard goes out of scope
+     */
+    class MoveGuard {
+    public:
+        MoveGuard(BasicIncrementalEvaluator& evaluator, int column, int height, bool aiPiece);
+        ~MoveGuard();
+
+        MoveGuard(const MoveGuard&) = delete;
+        MoveGuard& operator=(const MoveGuard&) = delete;
+
+    private:
+        BasicIncrementalEvaluator& evaluator;
+        int column;
+        int height;
+        bool aiPiece;
+    };
+
+    BasicIncrementalEvaluator();
+
+    /**
+     * Recomputes all window counts from scratch
+     * @param board The position to mirror
+     * @param aiPlayer Player whose pieces count positively ('X' or 'O')
+     */
+    void reset(const BoardT& board, char aiPlayer);
+
+    /**
+     * Records a piece added to the board
+     * @param column Column of the new piece
+     * @param height Height of the new piece, counted from the bottom
+     * @param aiPiece True if the piece belongs to the AI
+     */
+    void addPiece(int column, int height, bool aiPiece);
+
+    /**
+     * Takes back a piece recorded with addPiece
+     */
+    void removePiece(int column, int height, bool aiPiece);
+
+    /**
+     * @return Heuristic score of the mirrored position (positive favors AI)
+     */
+    int score() const;
+
+private:
+    // Per window: AI pieces + (K + 1) * opponent pieces
+    std::uint8_t windowStates[WINDOW_COUNT];
+    int total;
+};
+
+using IncrementalEvaluator = BasicIncrementalEvaluator<Board>;
+
+/**
+ * Heuristic score of one K-cell window by its AI and opponent piece counts,
+ * shared by all of MinimaxAI's evaluators. For K = 4: 1000 for four AI
+ * pieces, 100 for three, 10 for two; -80 and -10 for three and two opponent
+ * pieces. Windows holding pieces of both players are dead and score 0.
+ */
+template <int K>
+constexpr int windowScore(int aiCount, int humanCount) {
+    if (aiCount > 0 && humanCount > 0) {
+        return 0;
+    }
+    if (aiCount == K) {
+        return 1000;
+    }
+    if (aiCount > 0 && aiCount == K - 1) {
+        return 100;
+    }
+    if (aiCount > 0 && aiCount == K - 2) {
+        return 10;
+    }
+    if (humanCount > 0 && humanCount == K - 1) {
+        return -80;
+    }
+    if (humanCount > 0 && humanCount == K - 2) {
+        return -10;
+    }
+    return 0;
+}
+
+#endif // INCREMENTALEVALUATOR_H
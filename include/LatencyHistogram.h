@@ -0,0 +1,56 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * Histogram of latencies with bounded relative error, in the style of
+ * HdrHistogram
+ * Values below 2^SUB_BUCKET_BITS are counted exactly; above that each
+ * power of two is split into 2^(SUB_BUCKET_BITS - 1) equal buckets, so any
+ * value from 1 ns to centuries is kept to within 1% using a fixed 7424
+ * counters. Recording is a few instructions and never allocates, and
+ * histograms from several threads can be merged.
+ */
+class LatencyHistogram {
+public:
+    static const int SUB_BUCKET_BITS = 8;
+
+    LatencyHistogram();
+
+    /**
+     * Counts one value, e.g. a latency in nanoseconds
+     */
+    void record(std::uint64_t value);
+
+    /**
+     * Adds another histogram's counts to this one
+     */
+    void merge(const LatencyHistogram& other);
+
+    void reset();
+
+    std::uint64_t count() const;
+    std::uint64_t min() const;
+    std::uint64_t max() const;
+    double mean() const;
+
+    /**
+     * @param percentile Share of values at or below the result, from 0 to 100
+     * @return Highest value in the bucket holding that percentile (0 if empty)
+     */
+    std::uint64_t percentile(double percentile) const;
+
+private:
+    std::vector<std::uint64_t> counts;
+    std::uint64_t total;
+    std::uint64_t minValue;
+    std::uint64_t maxValue;
+    double sum;
+
+    static int bucketIndex(std::uint64_t value);
+    static std::uint64_t bucketHighest(int index);
+};
+
+#endif // LATENCYHISTOGRAM_H
@@ -0,0 +1,47 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+
+/**
+ * Read-only memory mapping of a whole file
+ * Pages are loaded by the operating system on first access, so opening even
+ * a large file costs nothing up front, and several processes mapping the
+ * same file share one copy in memory.
+ */
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * Maps a file, replacing any file mapped before
+     * @param path Path of the file to map
+     * @return False if the file can't be opened or mapped (empty files
+     *         can't be mapped either)
+     */
+    bool open(const std::string& path);
+
+    /**
+     * Unmaps the file; safe to call when nothing is mapped
+     */
+    void close();
+
+    bool isOpen() const;
+    const unsigned char* data() const;
+    std::size_t size() const;
+
+private:
+    const unsigned char* mappedData;
+    std::size_t mappedSize;
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#endif
+};
+
+#endif // MAPPEDFILE_H
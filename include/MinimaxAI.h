@@ -2,81 +2,378 @@
 #define MINIMAXAI_H
 
 #include "AIPlayer.h"
+#include "IncrementalEvaluator.h"
+#include "SearchStats.h"
+#include "TranspositionTable.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 #include <limits>
 
 /**
  * Minimax AI player with alpha-beta pruning
  * Provides "Medium" and "Hard" difficulty options based on search depth
+ *
+ * With more than one thread the search runs Lazy SMP: helper threads search
+ * the same position with slightly different move orders and share results
+ * through the lock-free transposition table, while the main thread's answer
+ * is the one played.
+ * @tparam BoardT The board variant the AI plays on
  */
-class MinimaxAI : public AIPlayer {
+template <typename BoardT>
+class BasicMinimaxAI : public BasicAIPlayer<BoardT> {
 public:
+    static constexpr std::size_t DEFAULT_TT_SIZE_MB = 16;
+    
     /**
      * Constructor
      * @param depth Search depth for minimax algorithm (1-8 recommended)
      * @param aiPlayer Character representing the AI player ('X' or 'O')
+     * @param ttSizeMB Transposition table size in megabytes (0 disables it)
+     * @param threads Number of search threads (1 searches on the caller's thread only)
+     */
+    BasicMinimaxAI(int depth = 4, char aiPlayer = 'O', std::size_t ttSizeMB = DEFAULT_TT_SIZE_MB,
+                   int threads = 1);
+    
+    /**
+     * Stops the helper threads
      */
-    MinimaxAI(int depth = 4, char aiPlayer = 'O');
-    ~MinimaxAI() override = default;
+    ~BasicMinimaxAI() override;
     
     /**
      * Selects the best move using minimax algorithm with alpha-beta pruning
      * @param board The current game board
      * @return Column index with the best evaluated move
      */
-    int selectMove(const Board& board) override;
+    int selectMove(const BoardT& board) override;
+    
+    /**
+     * Selects the best move by iterative deepening within the given budget
+     * The first iteration always runs to completion; after that the search
+     * stops as soon as a limit is hit and returns the best move of the last
+     * completed iteration. Positions in the opening book are played from the
+     * book without searching.
+     * @param board The current game board
+     * @param limits Depth, time and node budget for this search
+     * @return Column index with the best evaluated move
+     */
+    int selectMove(const BoardT& board, const SearchLimits& limits) override;
+    
+    /**
+     * Same search as above, also reporting nodes, leaf evaluations, cutoffs,
+     * table hits, depth, score and principal variation
+     * Statistics are gathered by a separately compiled copy of the search,
+     * so searches without a stats object don't pay for them at all.
+     * @param board The current game board
+     * @param limits Depth, time and node budget for this search
+     * @param stats Receives the search statistics (nullptr to skip collecting them)
+     * @return Column index with the best evaluated move
+     */
+    int selectMove(const BoardT& board, const SearchLimits& limits, SearchStats* stats) override;
+    
+    /**
+     * Selects a move for each position of a batch
+     * Rather than splitting one search between threads, each search thread
+     * takes whole positions, one after another, and searches them alone;
+     * with many positions this keeps every thread busy without any of the
+     * duplicated work of Lazy SMP. All positions share the transposition
+     * table, so positions from the same games reuse each other's results.
+     * The time and node limits apply to each position separately.
+     * @param boards Positions to search
+     * @param moves Receives the move for each position (-1 if it has none)
+     * @param count Number of positions
+     * @param limits Budget for each position's search
+     */
+    void selectMoves(const BoardT* boards, int* moves, std::size_t count, const SearchLimits& limits) override;
+    
+    /**
+     * @return Number of nodes visited by the most recent search or batch, summed over all threads
+     */
+    std::uint64_t getNodeCount() const;
+    
+    /**
+     * Enables or disables move ordering (on by default)
+     * With ordering off, moves are searched in plain column order, which is
+     * mainly useful for measuring what the ordering heuristics save.
+     * @param enabled True to order moves by TT move, killers and history
+     */
+    void setMoveOrdering(bool enabled);
+    
+    /**
+     * Forgets all cached search results, so the next search starts cold
+     */
+    void clearTranspositionTable();
+    
+    /**
+     * Clears the transposition table; the search itself has no random choices
+     */
+    void newGame(std::uint32_t seed) override;
+    
+    /**
+     * Evaluates the board position using heuristics
+     * Scores all K-cell windows (69 on the standard board) with bit-parallel
+     * counts over the bitboards, one direction at a time. The search itself reads the same
+     * score from its IncrementalEvaluator instead.
+     * @param board The game board to evaluate
+     * @return Score for the position (positive favors AI, negative favors opponent)
+     */
+    int evaluateBoard(const BoardT& board);
+    
+    /**
+     * Original cell-by-cell evaluator, kept for differential testing
+     * @param board The game board to evaluate
+     * @return Same score as evaluateBoard
+     */
+    int evaluateBoardReference(const BoardT& board);
     
 private:
+    static const int MAX_PLY = BoardT::ROWS * BoardT::COLS;
+    
+    using Evaluator = BasicIncrementalEvaluator<BoardT>;
+    
+    /**
+     * Fixed-capacity move list: at most one move per column, so it lives on
+     * the stack and move generation never touches the heap
+     */
+    struct MoveList {
+        int moves[BoardT::COLS];
+        int count = 0;
+        
+        void push(int col) {
+            moves[count++] = col;
+        }
+        
+        bool empty() const {
+            return count == 0;
+        }
+        
+        int operator[](int i) const {
+            return moves[i];
+        }
+        
+        int* begin() {
+            return moves;
+        }
+        
+        int* end() {
+            return moves + count;
+        }
+        
+        const int* begin() const {
+            return moves;
+        }
+        
+        const int* end() const {
+            return moves + count;
+        }
+    };
+    
+    /**
+     * Work handed to the helper threads: a Lazy SMP search of one position
+     * (moves == nullptr) or a share of a batch
+     */
+    struct HelperTask {
+        const BoardT* boards = nullptr;
+        int* moves = nullptr;
+        std::size_t count = 0;
+        const SearchLimits* limits = nullptr;
+        int maxDepth = 0;        // Lazy SMP only
+        std::size_t helpers = 0; // Helpers taking part
+    };
+    
+    /**
+     * Everything one search thread mutates: its own board and the matching
+     * leaf evaluation state, plus node count, stop state and move ordering tables
+     * Allocated with the engine and reset at the start of each search, so it
+     * doubles as the search's scratch arena and searching allocates nothing.
+     */
+    struct SearchWorker {
+        BoardT board;
+        Evaluator evaluator;
+        SearchStats* stats = nullptr; // Set on the main worker when collecting statistics
+        std::uint64_t nodeCount = 0;
+        bool enforcesLimits = false; // Applies the time and node budget (the main worker, or all in a batch)
+        bool limitsActive = false;   // Budget in force: the first iteration has completed
+        bool stopped = false;
+        std::chrono::steady_clock::time_point deadline;
+        MoveList rootMoves;
+        int iterationDepth = 0;
+        int killerMoves[MAX_PLY + 1][2];
+        int historyScores[2][BoardT::ROWS * BoardT::COLS];
+    };
+    
     int depth;
     char aiPlayer;
     char humanPlayer;
+    bool moveOrdering;
+    TranspositionTable transpositionTable;
+    
+    // Budget shared by all threads of the search in progress
+    std::uint64_t nodeLimit;
+    bool hasDeadline;
+    const std::atomic<bool>* externalStop; // SearchLimits::stop of the search in progress
+    std::atomic<bool> stopAll;
+    
+    SearchWorker mainWorker;
+    std::vector<std::unique_ptr<SearchWorker>> helperWorkers;
+    
+    // Helper threads live as long as the engine and sleep between searches,
+    // so a search doesn't start any threads
+    std::vector<std::thread> helperThreads;
+    std::mutex helperMutex;
+    std::condition_variable helperWake;  // A task was posted, or shutdown
+    std::condition_variable helperIdle;  // The last helper finished its task
+    HelperTask helperTask;
+    std::uint64_t helperGeneration;      // Bumped for every task posted
+    std::size_t helpersRunning;
+    bool helpersShutdown;
+    std::atomic<std::size_t> nextPosition; // Next unclaimed position of a batch
+    
+    /**
+     * Body of a helper thread: waits for tasks and runs them until shutdown
+     * @param index Index of the helper's worker in helperWorkers
+     */
+    void helperLoop(std::size_t index);
+    
+    /**
+     * Hands a task to the first task.helpers helpers and wakes them
+     */
+    void startHelpers(const HelperTask& task);
+    
+    /**
+     * Blocks until every helper has finished the current task
+     */
+    void waitForHelpers();
+    
+    /**
+     * Searches batch positions on one worker until none are left
+     * @param worker The worker to search with
+     * @param task The batch
+     */
+    void searchBatch(SearchWorker& worker, const HelperTask& task);
+    
+    /**
+     * Searches one position of a batch on a worker, start to finish
+     * @param worker The worker to search with
+     * @param board The position to search
+     * @param limits Budget for the position
+     * @return Best move, or -1 if the position has none
+     */
+    int searchPosition(SearchWorker& worker, const BoardT& board, const SearchLimits& limits);
+    
+    /**
+     * Runs iterative deepening on one worker
+     * @param worker The worker to search with
+     * @param board The position to search
+     * @param rootMoves Root moves in initial search order; reordered as the search goes
+     * @param firstDepth Depth of the first iteration
+     * @param maxDepth Depth of the last iteration
+     * @return Best move of the last completed iteration (rootMoves[0] if none)
+     */
+    int iterativeDeepening(SearchWorker& worker, const BoardT& board, MoveList& rootMoves,
+                           int firstDepth, int maxDepth);
+    
+    /**
+     * Searches every root move to a fixed depth
+     * @param worker The worker to search with (moves are applied to its board)
+     * @param searchDepth Depth of this iteration
+     * @param validMoves Root moves to search, in order
+     * @param bestScore Receives the score of the best move
+     * @tparam CollectStats True to collect statistics (see minimax)
+     * @return Best move, or -1 if the iteration was stopped before completing
+     */
+    template <bool CollectStats>
+    int searchRoot(SearchWorker& worker, int searchDepth, const MoveList& validMoves, int& bestScore);
+    
+    /**
+     * Orders the valid moves of an interior node, best candidates first:
+     * the transposition table move, then killer moves for this ply, then the
+     * rest by history score, with ties broken center-out
+     * @param worker The worker whose board and tables to use
+     * @param ply Distance from the root
+     * @param ttMove Best move stored for this position, or -1
+     * @param isMaximizing True if the AI is to move
+     * @param moves Receives the valid column indices in search order
+     */
+    void orderMoves(const SearchWorker& worker, int ply, int ttMove, bool isMaximizing, MoveList& moves);
+    
+    /**
+     * Updates killer and history tables after a move caused a cutoff
+     * @param worker The worker (with the move already taken back)
+     * @param ply Distance from the root
+     * @param col The move that caused the cutoff
+     * @param currentDepth Remaining depth at the node
+     * @param isMaximizing True if the AI was to move
+     */
+    void recordCutoff(SearchWorker& worker, int ply, int col, int currentDepth, bool isMaximizing);
+    
+    /**
+     * Checks whether the worker must stop: the caller cancelled the search,
+     * another thread finished it, or (main worker only) the time or node
+     * budget ran out
+     * @return True if the search must stop
+     */
+    bool checkLimits(SearchWorker& worker);
     
     /**
      * Core minimax algorithm with alpha-beta pruning
-     * @param board The game board (will be modified during search)
+     * @param worker The searching worker (moves are applied to and reverted on its board)
      * @param currentDepth Current depth in the search tree
      * @param alpha Best value for maximizer
      * @param beta Best value for minimizer
      * @param isMaximizing True if maximizing player's turn
+     * @tparam CollectStats True to count into worker.stats; false compiles the counting out
      * @return Evaluated score for this position
      */
-    int minimax(Board& board, int currentDepth, int alpha, int beta, bool isMaximizing);
+    template <bool CollectStats>
+    int minimax(SearchWorker& worker, int currentDepth, int alpha, int beta, bool isMaximizing);
     
     /**
-     * Evaluates the board position using heuristics
-     * @param board The game board to evaluate
-     * @return Score for the position (positive favors AI, negative favors opponent)
+     * Reads the principal variation out of the transposition table
+     * @param board The root position
+     * @param bestMove The move chosen at the root
+     * @param length Maximum number of moves to return
+     * @param line Receives the chosen move followed by the best replies
+     *             stored in the table, reusing its storage
      */
-    int evaluateBoard(const Board& board);
+    void principalVariation(const BoardT& board, int bestMove, int length, std::vector<int>& line);
     
     /**
-     * Evaluates a window of 4 cells
-     * @param window Array of 4 cells to evaluate
+     * Evaluates a window of K cells
+     * @param window Array of K cells to evaluate
      * @return Score for this window
      */
-    int evaluateWindow(const char window[4]);
+    int evaluateWindow(const char window[BoardT::CONNECT]);
     
     /**
      * Gets list of valid column indices (non-full columns)
      * @param board The game board
-     * @return Vector of valid column indices
+     * @param validMoves Receives the valid column indices, center-out when ordering is on
      */
-    std::vector<int> getValidMoves(const Board& board);
+    void getValidMoves(const BoardT& board, MoveList& validMoves);
     
     /**
      * Counts pieces of a specific player in a window
-     * @param window Array of 4 cells
+     * @param window Array of K cells
      * @param player Player character to count
      * @return Number of player's pieces in window
      */
-    int countPieces(const char window[4], char player);
+    int countPieces(const char window[BoardT::CONNECT], char player);
     
     /**
      * Checks if a window has empty cells
-     * @param window Array of 4 cells
+     * @param window Array of K cells
      * @return True if window contains at least one empty cell
      */
-    bool hasEmpty(const char window[4]);
+    bool hasEmpty(const char window[BoardT::CONNECT]);
 };
 
+using MinimaxAI = BasicMinimaxAI<Board>;
+
 #endif // MINIMAXAI_H
@@ -0,0 +1,95 @@
+#ifndef OPENINGBOOK_H
+#define OPENINGBOOK_H
+
+#include "Board.h"
+#include "MappedFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Precomputed best moves for the first plies of the game
+ * Books are written offline by the connect4_bookgen tool and memory-mapped at
+ * runtime, so opening one costs no parsing and a lookup is a binary search
+ * over the mapped file.
+ *
+ * File layout (all integers little-endian):
+ *   16-byte header: "C4BK", version, rows, cols, plies, entry count (64-bit)
+ *   entries: one 64-bit word per position, sorted ascending
+ * Each entry packs the position key (Board::getKey of the position or of its
+ * mirror image, whichever is smaller) into the top 49 bits, above the best
+ * move (3 bits, in the orientation of that key) and the exact score (6 bits,
+ * offset by 32). Keying by the whole word keeps the file sorted by position.
+ */
+class OpeningBook {
+public:
+    static const std::uint8_t FORMAT_VERSION = 1;
+
+    /**
+     * A book position in canonical orientation
+     */
+    struct Entry {
+        std::uint64_t key; // Canonical position key
+        int move;          // Best move for the player to move
+        int score;         // Exact score in SolverAI's convention
+    };
+
+    OpeningBook();
+
+    /**
+     * Maps a book file and checks its header
+     * @param path Path of the book file
+     * @return False if the file is missing, malformed or for another board size
+     */
+    bool open(const std::string& path);
+
+    void close();
+    bool isOpen() const;
+
+    /**
+     * @return Number of positions in the book
+     */
+    std::size_t size() const;
+
+    /**
+     * @return Plies from the empty board the book was generated for
+     */
+    int getPlies() const;
+
+    /**
+     * Looks up a position
+     * @param board The position to look up
+     * @param move Receives the best move on a hit
+     * @param score Receives the exact score for the player to move on a hit
+     * @return True if the position is in the book
+     */
+    bool probe(const Board& board, int& move, int& score) const;
+
+    /**
+     * Key shared by a position and its mirror image
+     * @param board The position
+     * @param mirrored Set to true if the key belongs to the mirror image,
+     *                 so moves must be flipped with Board::COLS - 1 - move
+     * @return The smaller of the two keys
+     */
+    static std::uint64_t canonicalKey(const Board& board, bool& mirrored);
+
+    /**
+     * Writes a book file
+     * @param path Path of the file to create
+     * @param entries Positions in canonical orientation, in any order
+     * @param plies Plies from the empty board the book covers
+     * @return False if the file can't be written
+     */
+    static bool write(const std::string& path, std::vector<Entry> entries, int plies);
+
+private:
+    MappedFile file;
+    std::size_t entryCount;
+    int plies;
+
+    std::uint64_t entryAt(std::size_t index) const;
+};
+
+#endif // OPENINGBOOK_H
@@ -2,27 +2,45 @@
 #define RANDOMAI_H
 
 #include "AIPlayer.h"
+#include <cstdint>
 #include <random>
 
 /**
  * Random AI player that selects moves randomly
  * This serves as the "Easy" difficulty option
+ * @tparam BoardT The board variant the AI plays on
  */
-class RandomAI : public AIPlayer {
+template <typename BoardT>
+class BasicRandomAI : public BasicAIPlayer<BoardT> {
 public:
-    RandomAI();
-    ~RandomAI() override = default;
+    BasicRandomAI();
+    
+    /**
+     * Constructor with a fixed seed, for reproducible games
+     * @param seed Seed for the move generator
+     */
+    explicit BasicRandomAI(std::uint32_t seed);
+    ~BasicRandomAI() override = default;
+    
+    using BasicAIPlayer<BoardT>::selectMove;
     
     /**
      * Selects a random valid move from all available columns
      * @param board The current game board
      * @return A randomly selected valid column index
      */
-    int selectMove(const Board& board) override;
+    int selectMove(const BoardT& board) override;
+    
+    /**
+     * Reseeds the move generator
+     */
+    void newGame(std::uint32_t seed) override;
     
 private:
     std::random_device rd;
     std::mt19937 gen;
 };
 
+using RandomAI = BasicRandomAI<Board>;
+
 #endif // RANDOMAI_H
@@ -0,0 +1,40 @@
+#ifndef SEARCHLIMITS_H
+#define SEARCHLIMITS_H
+
+#include "Board.h"
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Budget for a single AI move search
+ * Any combination of limits may be set; the search stops at whichever is
+ * reached first and plays the best move found by its last completed iteration.
+ */
+struct SearchLimits {
+    // Maximum search depth in plies (0 = the engine's configured depth)
+    int maxDepth = 0;
+    
+    // Wall-clock budget in milliseconds (0 = no time limit)
+    std::int64_t timeMs = 0;
+    
+    // Maximum number of nodes to visit (0 = no node limit)
+    std::uint64_t maxNodes = 0;
+    
+    // Set by another thread to abandon the search at once, even during the
+    // first iteration; the move returned then must be ignored (nullptr = none)
+    const std::atomic<bool>* stop = nullptr;
+    
+    /**
+     * Limits for a purely time-bounded search
+     * @param milliseconds Wall-clock budget for the move
+     * @return Limits with no depth cap and the given time budget
+     */
+    static SearchLimits timeBudget(std::int64_t milliseconds) {
+        SearchLimits limits;
+        limits.maxDepth = MAX_BOARD_CELLS;
+        limits.timeMs = milliseconds;
+        return limits;
+    }
+};
+
+#endif // SEARCHLIMITS_H
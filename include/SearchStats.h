@@ -0,0 +1,54 @@
+#ifndef SEARCHSTATS_H
+#define SEARCHSTATS_H
+
+#include "Board.h"
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+/**
+ * Statistics about a single AI move search
+ * Filled in by AIPlayer::selectMove when the caller passes a SearchStats
+ * object. Engines that can't provide a figure leave it at zero.
+ * For multi-threaded searches the counters describe the main search thread,
+ * except nodes, which covers all threads.
+ */
+struct SearchStats {
+    static const int MAX_PLY = MAX_BOARD_CELLS;
+
+    std::uint64_t nodes = 0;           // Positions visited
+    std::uint64_t leafEvaluations = 0; // Heuristic evaluations at the search horizon
+    std::uint64_t cutoffs = 0;         // Alpha-beta cutoffs, all plies
+    std::uint64_t cutoffsPerPly[MAX_PLY + 1] = {}; // Cutoffs by distance from the root
+    std::uint64_t ttProbes = 0;        // Transposition table lookups
+    std::uint64_t ttHits = 0;          // Lookups that found the position
+    std::uint64_t ttCutoffs = 0;       // Hits that answered the node without searching it
+    int depthReached = 0;              // Deepest completed iteration
+    int score = 0;                     // Score of the chosen move, in the engine's own units
+    double elapsedMs = 0.0;            // Wall-clock time of the search
+    std::vector<int> principalVariation; // Expected line of play, chosen move first
+
+    /**
+     * Clears every figure for a new search. The principal variation keeps
+     * room for MAX_PLY moves, so a SearchStats reused across searches only
+     * allocates the first time.
+     */
+    void reset();
+
+    /**
+     * @return Share of transposition table lookups that hit, between 0 and 1
+     */
+    double ttHitRate() const;
+
+    /**
+     * @return Average number of moves searched per ply: nodes^(1 / depthReached)
+     */
+    double effectiveBranchingFactor() const;
+
+    /**
+     * Writes a multi-line human-readable summary
+     */
+    void print(std::ostream& out) const;
+};
+
+#endif // SEARCHSTATS_H
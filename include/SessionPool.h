@@ -0,0 +1,118 @@
+#ifndef SESSIONPOOL_H
+#define SESSIONPOOL_H
+
+#include "EngineSpec.h"
+#include "GameState.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * Reference to a session in a SessionPool
+ * The generation distinguishes successive sessions in the same slot, so a
+ * handle to a closed session stays invalid after its slot is reused.
+ */
+struct SessionHandle {
+    static const std::uint32_t INVALID_INDEX = 0xFFFFFFFFu;
+
+    std::uint32_t index = INVALID_INDEX;
+    std::uint32_t generation = 0;
+
+    bool isValid() const {
+        return index != INVALID_INDEX;
+    }
+
+    /**
+     * @return Both fields in one 64-bit id, e.g. for a wire protocol
+     */
+    std::uint64_t toId() const {
+        return static_cast<std::uint64_t>(generation) << 32 | index;
+    }
+
+    static SessionHandle fromId(std::uint64_t id) {
+        SessionHandle handle;
+        handle.index = static_cast<std::uint32_t>(id);
+        handle.generation = static_cast<std::uint32_t>(id >> 32);
+        return handle;
+    }
+
+    bool operator==(const SessionHandle& other) const {
+        return index == other.index && generation == other.generation;
+    }
+
+    bool operator!=(const SessionHandle& other) const {
+        return !(*this == other);
+    }
+};
+
+/**
+ * One hosted game: its state plus the AI configuration, 40 bytes in all
+ */
+struct GameSession {
+    PackedGameState state;
+    EngineSpec engine;       // AI opponent, if any
+    char aiPlayer = ' ';     // 'X' or 'O' for the AI's pieces, ' ' for two human players
+    bool aiThinking = false; // An AI move has been requested and not applied yet
+};
+
+/**
+ * Fixed-capacity pool of game sessions
+ * Sessions live in slabs of SLAB_SIZE that are allocated as the pool grows
+ * and never freed or moved, so memory stays proportional to the peak
+ * number of sessions and pointers to sessions stay stable. Closed sessions
+ * go on a free list and their slots are reused first.
+ * Not thread-safe: one thread owns the pool.
+ */
+class SessionPool {
+public:
+    static const std::size_t SLAB_SIZE = 1024;
+
+    /**
+     * @param capacity Maximum number of simultaneous sessions
+     */
+    explicit SessionPool(std::size_t capacity);
+
+    /**
+     * Opens a session with a fresh game
+     * @return Handle of the new session, or an invalid handle if the pool is full
+     */
+    SessionHandle allocate();
+
+    /**
+     * Closes a session
+     * @return False if the handle is invalid or the session already closed
+     */
+    bool release(SessionHandle handle);
+
+    /**
+     * @return The session, or nullptr if the handle is invalid or the session closed
+     */
+    GameSession* get(SessionHandle handle);
+    const GameSession* get(SessionHandle handle) const;
+
+    /**
+     * @return Number of open sessions
+     */
+    std::size_t size() const;
+
+    std::size_t capacity() const;
+
+private:
+    struct Slot {
+        GameSession session;
+        std::uint32_t generation = 0;
+        std::uint32_t nextFree = SessionHandle::INVALID_INDEX;
+        bool inUse = false;
+    };
+
+    std::vector<std::unique_ptr<Slot[]>> slabs;
+    std::size_t maxSessions;
+    std::size_t slotCount; // Slots handed out at least once
+    std::size_t openSessions;
+    std::uint32_t freeHead;
+
+    Slot* slotAt(std::uint32_t index) const;
+};
+
+#endif // SESSIONPOOL_H
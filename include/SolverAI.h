@@ -0,0 +1,141 @@
+#ifndef SOLVERAI_H
+#define SOLVERAI_H
+
+#include "AIPlayer.h"
+#include "MinimaxAI.h"
+#include "TranspositionTable.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * Perfect-play AI player
+ * Solves positions exactly with a null-window negamax search over bitboards,
+ * backed by a transposition table and pruning of moves that lose at once.
+ * Provides the "Perfect" difficulty option and exact scores for analysis.
+ *
+ * Scores follow the usual Connect 4 solver convention, from the point of
+ * view of the player to move: 0 is a draw, a positive score means the
+ * player to move wins (the sooner, the higher: ROWS*COLS/2 + 1 minus the
+ * number of their own pieces on the board when they complete the line), and
+ * a negative score means they lose in the same sense.
+ *
+ * An exact solve of an early position can take hours. Given a budget, the
+ * solver spends half of it trying and, if the position isn't solved by
+ * then, plays the move of a MinimaxAI search within the rest, so only
+ * positions near the end or in the opening book are played perfectly.
+ * @tparam BoardT The board variant the AI plays on
+ */
+template <typename BoardT>
+class BasicSolverAI : public BasicAIPlayer<BoardT> {
+public:
+    static constexpr std::size_t DEFAULT_TT_SIZE_MB = 64;
+
+    /**
+     * Result of solving a position
+     */
+    struct SolveResult {
+        int score;      // Exact score for the player to move (see class comment)
+        int pliesToEnd; // Moves (both players) until the game ends under perfect play
+    };
+
+    /**
+     * Constructor
+     * The side to move is taken from the board itself ('X' always starts).
+     * @param ttSizeMB Transposition table size in megabytes
+     */
+    explicit BasicSolverAI(std::size_t ttSizeMB = DEFAULT_TT_SIZE_MB);
+    ~BasicSolverAI() override = default;
+
+    using BasicAIPlayer<BoardT>::selectMove;
+
+    /**
+     * Selects a move with the best exact score; among equally good moves the
+     * one closest to the center is played. Book positions are answered
+     * straight from the opening book.
+     * @param board The current game board
+     * @return Column index of an optimal move
+     */
+    int selectMove(const BoardT& board) override;
+    
+    /**
+     * Selects a move as above within a budget
+     * The solver gets half of the time and node budget; if it can't solve
+     * the position in that, a MinimaxAI search uses what is left. A depth
+     * limit is taken as how far ahead the solver may look: positions with
+     * more empty cells go straight to the fallback search at that depth.
+     * Without any limit the position is always solved exactly.
+     * @param board The current game board
+     * @param limits Depth, time and node budget for this search
+     * @return Column index of an optimal move, or of the fallback's best move
+     */
+    int selectMove(const BoardT& board, const SearchLimits& limits) override;
+    
+    /**
+     * Selects a move as above, reporting elapsed time and nodes searched
+     */
+    int selectMove(const BoardT& board, const SearchLimits& limits, SearchStats* stats) override;
+
+    /**
+     * Clears the transposition tables of the solver and its fallbacks
+     */
+    void newGame(std::uint32_t seed) override;
+
+    /**
+     * Solves a position exactly, taking the score from the opening book
+     * when the position is in it
+     * @param board A position without a winner
+     * @return Exact score and game length for the player to move
+     */
+    SolveResult solve(const BoardT& board);
+
+    /**
+     * @return Number of nodes visited since the solver was created,
+     *         fallback searches included
+     */
+    std::uint64_t getNodeCount() const;
+
+private:
+    using Bitboard = typename BoardT::Bitboard;
+
+    TranspositionTable transpositionTable;
+    std::uint64_t nodeCount;
+    const std::atomic<bool>* stopRequest; // SearchLimits::stop of the search in progress
+    std::uint64_t nodeLimit;              // nodeCount at which the solve gives up (0 = none)
+    bool hasDeadline;
+    std::chrono::steady_clock::time_point deadline;
+    bool stopped;
+
+    // Searches positions the budget can't solve, one per color, created on first use
+    std::unique_ptr<BasicMinimaxAI<BoardT>> fallbacks[2];
+
+    /**
+     * Finds a move by solving every child of the position
+     * @return Column index of an optimal move (meaningless once stopped)
+     */
+    int solveMove(const BoardT& board);
+
+    /**
+     * Null-window capable negamax with alpha-beta pruning
+     * @param current Bitboard of the player to move
+     * @param mask Bitboard of all occupied cells
+     * @param moves Number of pieces on the board
+     * @param alpha Lower bound of the search window
+     * @param beta Upper bound of the search window
+     * @return Exact score if it lies within (alpha, beta), otherwise a bound
+     *         (meaningless once the search has been stopped)
+     */
+    int negamax(Bitboard current, Bitboard mask, int moves, int alpha, int beta);
+
+    /**
+     * Solves a position given as bitboards by narrowing null-window searches
+     * @return Exact score for the player to move
+     */
+    int solvePosition(Bitboard current, Bitboard mask, int moves);
+};
+
+using SolverAI = BasicSolverAI<Board>;
+
+#endif // SOLVERAI_H
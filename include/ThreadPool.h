@@ -0,0 +1,60 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Fixed set of worker threads running queued tasks in FIFO order
+ * Used by the command-line tools to spread independent work (self-play
+ * games, batches of positions) over all cores.
+ */
+class ThreadPool {
+public:
+    /**
+     * Constructor
+     * @param threads Number of worker threads (0 = one per hardware thread)
+     */
+    explicit ThreadPool(int threads = 0);
+
+    /**
+     * Finishes all queued tasks, then stops the workers
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * Queues a task; tasks must not throw
+     */
+    void submit(std::function<void()> task);
+
+    /**
+     * Blocks until every task submitted so far has finished
+     */
+    void wait();
+
+    /**
+     * @return Number of worker threads
+     */
+    int size() const;
+
+private:
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable taskAvailable;
+    std::condition_variable allDone;
+    std::size_t running;
+    bool stopping;
+
+    void workerLoop();
+};
+
+#endif // THREADPOOL_H
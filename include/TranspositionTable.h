@@ -0,0 +1,82 @@
+#ifndef TRANSPOSITIONTABLE_H
+#define TRANSPOSITIONTABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * Fixed-size transposition table for game tree search
+ * Caches search results by position key so that positions reached through
+ * different move orders are only searched once. The number of entries is
+ * always a power of two; colliding positions simply overwrite each other.
+ *
+ * The table is lock-free and may be shared by several search threads. Each
+ * slot stores the packed entry next to the entry XOR-ed with its key, so a
+ * slot torn by two concurrent writers simply fails the key check on probe.
+ */
+class TranspositionTable {
+public:
+    enum class Bound : std::uint8_t {
+        EXACT,  // Score is the exact minimax value
+        LOWER,  // Search failed high: true value >= score
+        UPPER   // Search failed low: true value <= score
+    };
+
+    struct Entry {
+        std::uint64_t key;
+        std::int32_t score;
+        std::int8_t depth;
+        Bound bound;
+        std::int8_t bestMove;
+    };
+
+    /**
+     * Constructor
+     * @param sizeInMB Memory budget in megabytes, rounded down to a power-of-two
+     *                 number of entries (0 disables the table)
+     */
+    explicit TranspositionTable(std::size_t sizeInMB);
+
+    /**
+     * Looks up a position
+     * @param key Position key
+     * @param entry Receives the stored entry on a hit
+     * @return True if an entry for exactly this key is stored
+     */
+    bool probe(std::uint64_t key, Entry& entry) const;
+
+    /**
+     * Stores a search result, replacing whatever occupied the slot unless it
+     * holds a deeper result for the same position
+     */
+    void store(std::uint64_t key, int score, int depth, Bound bound, int bestMove);
+
+    /**
+     * Forgets every entry
+     * Entries are tagged with the generation that stored them, so this only
+     * starts a new generation; the slots are wiped when the counter wraps.
+     */
+    void clear();
+
+    std::size_t size() const;
+
+private:
+    struct Slot {
+        std::atomic<std::uint64_t> check; // key ^ data
+        std::atomic<std::uint64_t> data;  // packed Entry fields
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    std::size_t slotCount;
+    int indexShift;
+    std::uint8_t generation; // Entries of other generations never match
+
+    void wipe();
+    std::size_t indexOf(std::uint64_t key) const;
+    static std::uint64_t pack(int score, int depth, Bound bound, int bestMove);
+    static void unpack(std::uint64_t data, Entry& entry);
+};
+
+#endif // TRANSPOSITIONTABLE_H
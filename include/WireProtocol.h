@@ -0,0 +1,130 @@
+#ifndef WIREPROTOCOL_H
+#define WIREPROTOCOL_H
+
+#include "EngineSpec.h"
+#include "GameState.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Binary protocol spoken by connect4_server
+ * Every message is a frame: length of the rest of the frame (2 bytes),
+ * message type (1 byte), then the body, all integers little-endian. Boards travel as the two
+ * players' bitboards (see Board::getPlayerMask: bit column * 7 + height,
+ * counted from the bottom), so a snapshot is 28 bytes and a client needs no
+ * move history to know the position.
+ *
+ * Client to server:
+ *   NEW_GAME    AI color ('X', 'O', or ' ' for none), engine kind, depth
+ *   MOVE        session id (8), column (1)
+ *   CLOSE_GAME  session id (8)
+ *   PING        token (8)
+ * Server to client:
+ *   GAME_STATE  session id (8), X bitboard (8), O bitboard (8), move count,
+ *               last column (0xFF if none), player to move, result
+ *   ERROR       session id (8), error code, type of the rejected request
+ *   PONG        token (8)
+ *
+ * Each request gets its reply in order: NEW_GAME and MOVE a GAME_STATE,
+ * CLOSE_GAME nothing unless it fails, PING a PONG. AI moves are pushed as
+ * further GAME_STATE messages when they are ready. The result byte follows
+ * GameRecord: 'X' or 'O' for the winner, ' ' for a draw, '?' while playing.
+ */
+enum class MessageType : std::uint8_t {
+    NEW_GAME = 1,
+    MOVE = 2,
+    CLOSE_GAME = 3,
+    PING = 4,
+    GAME_STATE = 0x81,
+    ERROR = 0x82,
+    PONG = 0x84
+};
+
+enum class WireError : std::uint8_t {
+    NONE = 0,
+    UNKNOWN_SESSION = 1,
+    ILLEGAL_MOVE = 2, // Column full or invalid, game over or not the client's turn
+    SERVER_FULL = 3,
+    BAD_REQUEST = 4,  // Unsupported engine or AI color, or the solver when the server refuses it
+    AI_FAILED = 5     // Sent as the rejection of the AI's MOVE when it found no legal move; the game is closed
+};
+
+/**
+ * Any protocol message; only the fields of its type are meaningful
+ */
+struct WireMessage {
+    MessageType type = MessageType::PING;
+    std::uint64_t session = 0;
+    std::uint64_t token = 0;
+
+    // NEW_GAME
+    char aiPlayer = ' ';
+    EngineSpec engine;
+
+    // MOVE and GAME_STATE
+    int column = -1; // In GAME_STATE, the last move played (-1 if none)
+
+    // GAME_STATE
+    std::uint64_t xMask = 0;
+    std::uint64_t oMask = 0;
+    int moveCount = 0;
+    char toMove = 'X';
+    char result = '?';
+
+    // ERROR
+    WireError error = WireError::NONE;
+    MessageType rejected = MessageType::PING;
+};
+
+enum class DecodeStatus {
+    COMPLETE,   // A message was decoded
+    INCOMPLETE, // More bytes are needed
+    MALFORMED   // The stream is corrupt and the connection should be dropped
+};
+
+/**
+ * Encoding and decoding of protocol frames
+ */
+class WireProtocol {
+public:
+    static const std::size_t LENGTH_SIZE = 2;
+
+    // Longest frame of any message type, length field included
+    static const std::size_t MAX_FRAME_SIZE = 32;
+
+    /**
+     * Appends a message's frame to a buffer
+     * @param message Message to encode
+     * @param out Buffer the frame is appended to
+     */
+    static void encode(const WireMessage& message, std::vector<unsigned char>& out);
+
+    /**
+     * Decodes the frame at the start of a buffer
+     * @param data Received bytes
+     * @param size Number of bytes available
+     * @param message Receives the message when COMPLETE
+     * @param consumed Receives the frame size when COMPLETE
+     * @return Whether a message was decoded, more bytes are needed or the
+     *         data is malformed
+     */
+    static DecodeStatus decode(const unsigned char* data, std::size_t size, WireMessage& message,
+                               std::size_t& consumed);
+
+    /**
+     * Fills in the GAME_STATE fields of a message from a game
+     * @param state Game to send
+     * @param message Receives the type and board fields; session is left alone
+     */
+    static void snapshot(const PackedGameState& state, WireMessage& message);
+
+    /**
+     * @param state A GAME_STATE message
+     * @param column Column to test
+     * @return True if the column is full or out of range in that position
+     */
+    static bool isColumnFull(const WireMessage& state, int column);
+};
+
+#endif // WIREPROTOCOL_H
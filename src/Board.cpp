@@ -1,137 +1,272 @@
 #include "Board.h"
 #include <iostream>
 
-Board::Board() {
-    grid.resize(ROWS, std::vector<char>(COLS, ' '));
+template <int Rows, int Cols, int K>
+BasicBoard<Rows, Cols, K>::BasicBoard() {
+    reset();
 }
 
-bool Board::dropPiece(int column, char player) {
+template <int Rows, int Cols, int K>
+BasicBoard<Rows, Cols, K> BasicBoard<Rows, Cols, K>::fromMasks(Bitboard xMask, Bitboard oMask, int lastColumn) {
+    BasicBoard board;
+    board.pieces[0] = xMask;
+    board.pieces[1] = oMask;
+    Bitboard occupied = xMask | oMask;
+    for (int col = 0; col < Cols; col++) {
+        board.heights[col] = static_cast<std::uint8_t>(popcount(occupied & columnMask(col)));
+    }
+
+    board.moveCount = static_cast<std::uint8_t>(popcount(occupied));
+    for (int ply = 0; ply < board.moveCount; ply++) {
+        board.moveHistory[ply] = UNKNOWN_MOVE;
+    }
+    if (board.moveCount > 0 && board.isValidColumn(lastColumn)) {
+        board.moveHistory[board.moveCount - 1] = static_cast<std::uint8_t>(lastColumn);
+    }
+    return board;
+}
+
+template <int Rows, int Cols, int K>
+bool BasicBoard<Rows, Cols, K>::dropPiece(int column, char player, int* landingRow) {
     if (!isValidColumn(column)) {
         return false;
     }
-    
+
+    int index = playerIndex(player);
+    if (index < 0) {
+        return false;
+    }
+
     int row = getNextAvailableRow(column);
     if (row == -1) {
         return false;
     }
-    
-    grid[row][column] = player;
+
+    pieces[index] |= cellBit(row, column);
+    heights[column]++;
+    moveHistory[moveCount++] = static_cast<std::uint8_t>(column);
+    if (landingRow) {
+        *landingRow = row;
+    }
     return true;
 }
 
-bool Board::checkWin(char player) const {
-    // Check horizontal
-    for (int row = 0; row < ROWS; row++) {
-        for (int col = 0; col <= COLS - 4; col++) {
-            if (checkDirection(row, col, 0, 1, player)) {
-                return true;
-            }
-        }
+template <int Rows, int Cols, int K>
+bool BasicBoard<Rows, Cols, K>::undoMove(int column) {
+    // The column check also rejects UNKNOWN_MOVE, left by fromMasks
+    if (!isValidColumn(column) || moveCount == 0 || moveHistory[moveCount - 1] != column) {
+        return false;
     }
-    
-    // Check vertical
-    for (int row = 0; row <= ROWS - 4; row++) {
-        for (int col = 0; col < COLS; col++) {
-            if (checkDirection(row, col, 1, 0, player)) {
-                return true;
-            }
-        }
+
+    moveCount--;
+    heights[column]--;
+    Bitboard bit = cellBit(Rows - 1 - heights[column], column);
+    pieces[0] &= ~bit;
+    pieces[1] &= ~bit;
+    return true;
+}
+
+template <int Rows, int Cols, int K>
+bool BasicBoard<Rows, Cols, K>::checkWin(char player) const {
+    int index = playerIndex(player);
+    if (index < 0) {
+        return false;
     }
-    
-    // Check diagonal (down-right)
-    for (int row = 0; row <= ROWS - 4; row++) {
-        for (int col = 0; col <= COLS - 4; col++) {
-            if (checkDirection(row, col, 1, 1, player)) {
-                return true;
-            }
-        }
+    return hasLine(pieces[index]);
+}
+
+template <int Rows, int Cols, int K>
+bool BasicBoard<Rows, Cols, K>::lastMoveWins() const {
+    if (moveCount == 0) {
+        return false;
     }
-    
-    // Check diagonal (down-left)
-    for (int row = 0; row <= ROWS - 4; row++) {
-        for (int col = 3; col < COLS; col++) {
-            if (checkDirection(row, col, 1, -1, player)) {
-                return true;
-            }
-        }
+
+    // Walking outwards from the new piece costs a branch per cell; as no
+    // line existed before the move, a whole-board check of the mover's
+    // pieces finds the same lines in a few branch-free shifts
+    int column = moveHistory[moveCount - 1];
+    if (column == UNKNOWN_MOVE) {
+        return hasLine(pieces[0]) || hasLine(pieces[1]);
     }
-    
-    return false;
+    Bitboard bit = cellBit(Rows - heights[column], column);
+    return hasLine((pieces[0] & bit) ? pieces[0] : pieces[1]);
 }
 
-bool Board::isFull() const {
-    for (int col = 0; col < COLS; col++) {
-        if (grid[0][col] == ' ') {
-            return false;
-        }
-    }
-    return true;
+template <int Rows, int Cols, int K>
+bool BasicBoard<Rows, Cols, K>::isFull() const {
+    return moveCount == Rows * Cols;
 }
 
-void Board::display() const {
+template <int Rows, int Cols, int K>
+void BasicBoard<Rows, Cols, K>::display() const {
     std::cout << "\n  ";
-    for (int col = 0; col < COLS; col++) {
+    for (int col = 0; col < Cols; col++) {
         std::cout << col + 1 << " ";
     }
     std::cout << "\n";
-    
-    for (int row = 0; row < ROWS; row++) {
+
+    for (int row = 0; row < Rows; row++) {
         std::cout << "| ";
-        for (int col = 0; col < COLS; col++) {
-            std::cout << grid[row][col] << " ";
+        for (int col = 0; col < Cols; col++) {
+            std::cout << getCell(row, col) << " ";
         }
         std::cout << "|\n";
     }
-    
+
     std::cout << "+";
-    for (int col = 0; col < COLS; col++) {
+    for (int col = 0; col < Cols; col++) {
         std::cout << "--";
     }
     std::cout << "+\n";
 }
 
-void Board::reset() {
-    for (int row = 0; row < ROWS; row++) {
-        for (int col = 0; col < COLS; col++) {
-            grid[row][col] = ' ';
-        }
+template <int Rows, int Cols, int K>
+void BasicBoard<Rows, Cols, K>::reset() {
+    pieces[0] = 0;
+    pieces[1] = 0;
+    for (int col = 0; col < Cols; col++) {
+        heights[col] = 0;
     }
+    moveCount = 0;
 }
 
-char Board::getCell(int row, int col) const {
-    if (row >= 0 && row < ROWS && col >= 0 && col < COLS) {
-        return grid[row][col];
+template <int Rows, int Cols, int K>
+char BasicBoard<Rows, Cols, K>::getCell(int row, int col) const {
+    // Cells above the column's stack are empty without looking at the bitboards
+    if (row >= 0 && row < Rows && col >= 0 && col < Cols && Rows - 1 - row < heights[col]) {
+        Bitboard bit = cellBit(row, col);
+        if (pieces[0] & bit) {
+            return 'X';
+        }
+        if (pieces[1] & bit) {
+            return 'O';
+        }
     }
     return ' ';
 }
 
-bool Board::isColumnFull(int column) const {
+template <int Rows, int Cols, int K>
+bool BasicBoard<Rows, Cols, K>::isColumnFull(int column) const {
     if (!isValidColumn(column)) {
         return true;
     }
-    return getNextAvailableRow(column) == -1;
+    return heights[column] >= Rows;
 }
 
-bool Board::checkDirection(int row, int col, int dRow, int dCol, char player) const {
-    for (int i = 0; i < 4; i++) {
-        int r = row + i * dRow;
-        int c = col + i * dCol;
-        if (r < 0 || r >= ROWS || c < 0 || c >= COLS || grid[r][c] != player) {
-            return false;
-        }
+template <int Rows, int Cols, int K>
+int BasicBoard<Rows, Cols, K>::getColumnHeight(int column) const {
+    if (!isValidColumn(column)) {
+        return Rows;
     }
-    return true;
+    return heights[column];
 }
 
-bool Board::isValidColumn(int column) const {
-    return column >= 0 && column < COLS;
+template <int Rows, int Cols, int K>
+int BasicBoard<Rows, Cols, K>::getMoveCount() const {
+    return moveCount;
 }
 
-int Board::getNextAvailableRow(int column) const {
-    for (int row = ROWS - 1; row >= 0; row--) {
-        if (grid[row][column] == ' ') {
-            return row;
-        }
+template <int Rows, int Cols, int K>
+int BasicBoard<Rows, Cols, K>::getMove(int ply) const {
+    if (ply < 0 || ply >= moveCount || moveHistory[ply] == UNKNOWN_MOVE) {
+        return -1;
+    }
+    return moveHistory[ply];
+}
+
+template <int Rows, int Cols, int K>
+typename BasicBoard<Rows, Cols, K>::Bitboard BasicBoard<Rows, Cols, K>::getPlayerMask(char player) const {
+    int index = playerIndex(player);
+    return index < 0 ? Bitboard(0) : pieces[index];
+}
+
+template <int Rows, int Cols, int K>
+typename BasicBoard<Rows, Cols, K>::Bitboard BasicBoard<Rows, Cols, K>::getOccupiedMask() const {
+    return pieces[0] | pieces[1];
+}
+
+template <int Rows, int Cols, int K>
+typename BasicBoard<Rows, Cols, K>::Bitboard BasicBoard<Rows, Cols, K>::getKey() const {
+    // occupied + bottom sets exactly the first empty cell of every column,
+    // which together with X's pieces pins down the whole position
+    return pieces[0] + getOccupiedMask() + bottomMask();
+}
+
+template <int Rows, int Cols, int K>
+BasicBoard<Rows, Cols, K>::MoveGuard::MoveGuard(BasicBoard& board, int column, char player)
+    : board(board), column(column) {
+    dropped = board.dropPiece(column, player);
+}
+
+template <int Rows, int Cols, int K>
+BasicBoard<Rows, Cols, K>::MoveGuard::~MoveGuard() {
+    if (dropped) {
+        board.undoMove(column);
+    }
+}
+
+template <int Rows, int Cols, int K>
+bool BasicBoard<Rows, Cols, K>::MoveGuard::applied() const {
+    return dropped;
+}
+
+template <int Rows, int Cols, int K>
+int BasicBoard<Rows, Cols, K>::playerIndex(char player) {
+    if (player == 'X') {
+        return 0;
+    }
+    if (player == 'O') {
+        return 1;
     }
     return -1;
 }
+
+template <int Rows, int Cols, int K>
+typename BasicBoard<Rows, Cols, K>::Bitboard BasicBoard<Rows, Cols, K>::cellBit(int row, int col) {
+    // Rows are numbered from the top, bitboard heights from the bottom
+    return Bitboard(1) << (col * COLUMN_BITS + (Rows - 1 - row));
+}
+
+template <int Rows, int Cols, int K>
+bool BasicBoard<Rows, Cols, K>::hasLine(Bitboard bits) {
+    // Shift distances for vertical, diagonal (\), horizontal and diagonal (/)
+    const int directions[4] = {1, Rows, Rows + 1, Rows + 2};
+
+    // All four directions are combined before testing, so the check costs
+    // the same straight-line code whether or not a line is found
+    Bitboard found = 0;
+    for (int shift : directions) {
+        // Double the run length while it fits in K, then overlap two runs
+        // to cover the rest: for K = 4, runs of 2 and then of 4
+        Bitboard runs = bits;
+        int length = 1;
+        while (2 * length <= K) {
+            runs &= runs >> (length * shift);
+            length *= 2;
+        }
+        if (length < K) {
+            runs &= runs >> ((K - length) * shift);
+        }
+        found |= runs;
+    }
+    return found != 0;
+}
+
+template <int Rows, int Cols, int K>
+bool BasicBoard<Rows, Cols, K>::isValidColumn(int column) const {
+    return column >= 0 && column < Cols;
+}
+
+template <int Rows, int Cols, int K>
+int BasicBoard<Rows, Cols, K>::getNextAvailableRow(int column) const {
+    if (heights[column] >= Rows) {
+        return -1;
+    }
+    return Rows - 1 - heights[column];
+}
+
+// The variants aliased in Board.h
+template class BasicBoard<6, 7, 4>;
+template class BasicBoard<7, 8, 4>;
+template class BasicBoard<7, 9, 4>;
+template class BasicBoard<6, 9, 5>;
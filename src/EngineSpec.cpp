@@ -0,0 +1,69 @@
+#include "EngineSpec.h"
+#include "MinimaxAI.h"
+#include "RandomAI.h"
+#include "SolverAI.h"
+#include <cstdlib>
+
+bool EngineSpec::parse(const std::string& text, EngineSpec& spec) {
+    std::string name = text;
+    std::string argument;
+    std::size_t colon = text.find(':');
+    if (colon != std::string::npos) {
+        name = text.substr(0, colon);
+        argument = text.substr(colon + 1);
+    }
+
+    if (name == "random" && argument.empty()) {
+        spec.kind = Kind::RANDOM;
+        return true;
+    }
+    if (name == "solver" && argument.empty()) {
+        spec.kind = Kind::SOLVER;
+        return true;
+    }
+    if (name == "minimax") {
+        spec.kind = Kind::MINIMAX;
+        spec.depth = 4;
+        if (!argument.empty()) {
+            char* end = nullptr;
+            long depth = std::strtol(argument.c_str(), &end, 10);
+            if (*end != '\0' || depth < 1 || depth > MAX_BOARD_CELLS) {
+                return false;
+            }
+            spec.depth = static_cast<int>(depth);
+        }
+        return true;
+    }
+    return false;
+}
+
+std::string EngineSpec::toString() const {
+    switch (kind) {
+        case Kind::RANDOM:
+            return "random";
+        case Kind::SOLVER:
+            return "solver";
+        case Kind::MINIMAX:
+            break;
+    }
+    return "minimax:" + std::to_string(depth);
+}
+
+template <typename BoardT>
+std::unique_ptr<BasicAIPlayer<BoardT>> EngineSpec::create(char player, std::size_t ttSizeMB, std::uint32_t seed) const {
+    switch (kind) {
+        case Kind::RANDOM:
+            return std::make_unique<BasicRandomAI<BoardT>>(seed);
+        case Kind::SOLVER:
+            return std::make_unique<BasicSolverAI<BoardT>>(ttSizeMB);
+        case Kind::MINIMAX:
+            break;
+    }
+    return std::make_unique<BasicMinimaxAI<BoardT>>(depth, player, ttSizeMB);
+}
+
+// The variants aliased in Board.h
+template std::unique_ptr<BasicAIPlayer<Board>> EngineSpec::create<Board>(char, std::size_t, std::uint32_t) const;
+template std::unique_ptr<BasicAIPlayer<Board8x7>> EngineSpec::create<Board8x7>(char, std::size_t, std::uint32_t) const;
+template std::unique_ptr<BasicAIPlayer<Board9x7>> EngineSpec::create<Board9x7>(char, std::size_t, std::uint32_t) const;
+template std::unique_ptr<BasicAIPlayer<Board9x6Connect5>> EngineSpec::create<Board9x6Connect5>(char, std::size_t, std::uint32_t) const;
@@ -1,21 +1,42 @@
 #include "Game.h"
 #include "RandomAI.h"
 #include "MinimaxAI.h"
+#include "SolverAI.h"
+#include <chrono>
 #include <iostream>
 #include <limits>
 
+namespace {
+
+// Budget of the Perfect difficulty when no limits have been set: only
+// positions the solver can finish in this time are played perfectly
+const std::int64_t PERFECT_MOVE_TIME_MS = 3000;
+
+} // namespace
+
 Game::Game() 
-    : currentPlayer('X'), gameOver(false), winner(' '),
-      gameMode(GameMode::PLAYER_VS_PLAYER), 
+    : gameMode(GameMode::PLAYER_VS_PLAYER), 
       aiDifficulty(AIDifficulty::MEDIUM),
       minimaxDepth(4),
-      aiPlayerChar('O') {}
+      ttSizeMB(MinimaxAI::DEFAULT_TT_SIZE_MB),
+      searchThreads(1),
+      collectSearchStats(false),
+      aiPlayerChar('O'),
+      stopAIMove(false),
+      stopPonder(false) {}
+
+Game::~Game() {
+    stopPondering();
+    cancelAIMove();
+}
 
 void Game::setGameMode(GameMode mode) {
     gameMode = mode;
     if (mode == GameMode::PLAYER_VS_AI) {
         initializeAI();
     } else {
+        stopPondering();
+        cancelAIMove();
         aiPlayer.reset();
     }
 }
@@ -35,73 +56,255 @@ void Game::setMinimaxDepth(int depth) {
     }
 }
 
+void Game::setTranspositionTableSize(std::size_t megabytes) {
+    ttSizeMB = megabytes;
+    if (gameMode == GameMode::PLAYER_VS_AI && 
+        (aiDifficulty == AIDifficulty::MEDIUM || aiDifficulty == AIDifficulty::HARD)) {
+        initializeAI();
+    }
+}
+
+void Game::setSearchLimits(const SearchLimits& limits) {
+    stopPondering();
+    clearPonderedReplies();
+    searchLimits = limits;
+}
+
+void Game::setSearchThreads(int threads) {
+    searchThreads = threads;
+    if (gameMode == GameMode::PLAYER_VS_AI && 
+        (aiDifficulty == AIDifficulty::MEDIUM || aiDifficulty == AIDifficulty::HARD)) {
+        initializeAI();
+    }
+}
+
+bool Game::setOpeningBook(const std::string& path) {
+    stopPondering();
+    clearPonderedReplies();
+    cancelAIMove();
+    auto book = std::make_shared<OpeningBook>();
+    if (!book->open(path)) {
+        return false;
+    }
+    
+    openingBook = book;
+    if (aiPlayer) {
+        aiPlayer->setOpeningBook(openingBook);
+    }
+    return true;
+}
+
+void Game::setCollectSearchStats(bool enabled) {
+    collectSearchStats = enabled;
+}
+
+const SearchStats& Game::getLastSearchStats() const {
+    return lastSearchStats;
+}
+
 GameMode Game::getGameMode() const {
     return gameMode;
 }
 
 bool Game::isAITurn() const {
     return gameMode == GameMode::PLAYER_VS_AI && 
-           currentPlayer == aiPlayerChar && 
-           !gameOver;
+           state.getCurrentPlayer() == aiPlayerChar && 
+           !state.isGameOver();
 }
 
 void Game::initializeAI() {
+    stopPondering();
+    clearPonderedReplies();
+    cancelAIMove();
     switch (aiDifficulty) {
         case AIDifficulty::EASY:
             aiPlayer = std::make_unique<RandomAI>();
             break;
         case AIDifficulty::MEDIUM:
-            aiPlayer = std::make_unique<MinimaxAI>(4, aiPlayerChar);
+            aiPlayer = std::make_unique<MinimaxAI>(4, aiPlayerChar, ttSizeMB, searchThreads);
             break;
         case AIDifficulty::HARD:
-            aiPlayer = std::make_unique<MinimaxAI>(minimaxDepth, aiPlayerChar);
+            aiPlayer = std::make_unique<MinimaxAI>(minimaxDepth, aiPlayerChar, ttSizeMB, searchThreads);
+            break;
+        case AIDifficulty::PERFECT:
+            aiPlayer = std::make_unique<SolverAI>();
             break;
     }
+    aiPlayer->setOpeningBook(openingBook);
 }
 
 int Game::getAIMove() {
     if (aiPlayer && isAITurn()) {
-        return aiPlayer->selectMove(board);
+        return aiPlayer->selectMove(state.getBoard(), moveLimits(), collectSearchStats ? &lastSearchStats : nullptr);
     }
     return -1;
 }
 
 void Game::makeAIMove() {
+    stopPondering();
+    cancelAIMove();
     if (isAITurn() && aiPlayer) {
-        int column = aiPlayer->selectMove(board);
+        int column;
+        if (takePonderedReply(column)) {
+            if (collectSearchStats) {
+                lastSearchStats = pendingSearchStats;
+            }
+        } else {
+            column = aiPlayer->selectMove(state.getBoard(), moveLimits(), collectSearchStats ? &lastSearchStats : nullptr);
+        }
         if (column >= 0) {
             makeMove(column);
         }
     }
 }
 
-bool Game::makeMove(int column) {
-    if (gameOver) {
+bool Game::beginAIMove() {
+    if (isAIThinking()) {
+        return true;
+    }
+    if (!aiPlayer || !isAITurn()) {
         return false;
     }
     
-    if (!board.dropPiece(column, currentPlayer)) {
+    // A reply found while pondering is played without searching again
+    stopPondering();
+    int ponderedMove;
+    if (takePonderedReply(ponderedMove)) {
+        std::promise<int> reply;
+        reply.set_value(ponderedMove);
+        pendingAIMove = reply.get_future();
+        return true;
+    }
+    
+    // The search works on its own copy of the board and limits, so the UI
+    // can keep reading the game while it runs
+    stopAIMove.store(false);
+    SearchLimits limits = moveLimits();
+    limits.stop = &stopAIMove;
+    SearchStats* stats = collectSearchStats ? &pendingSearchStats : nullptr;
+    AIPlayer* ai = aiPlayer.get();
+    pendingAIMove = std::async(std::launch::async, [ai, position = state.getBoard(), limits, stats]() {
+        return ai->selectMove(position, limits, stats);
+    });
+    return true;
+}
+
+bool Game::pollAIMove() {
+    if (!isAIThinking() ||
+        pendingAIMove.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
         return false;
     }
     
-    if (board.checkWin(currentPlayer)) {
-        gameOver = true;
-        winner = currentPlayer;
-    } else if (board.isFull()) {
-        gameOver = true;
-        winner = ' ';
-    } else {
-        switchPlayer();
+    int column = pendingAIMove.get();
+    if (collectSearchStats) {
+        lastSearchStats = pendingSearchStats;
+    }
+    return column >= 0 && makeMove(column);
+}
+
+void Game::cancelAIMove() {
+    if (!isAIThinking()) {
+        return;
+    }
+    stopAIMove.store(true);
+    pendingAIMove.wait();
+    pendingAIMove = std::future<int>();
+}
+
+bool Game::isAIThinking() const {
+    return pendingAIMove.valid();
+}
+
+bool Game::startPondering() {
+    if (isPondering()) {
+        return true;
+    }
+    if (!aiPlayer || gameMode != GameMode::PLAYER_VS_AI || state.isGameOver() ||
+        state.getCurrentPlayer() == aiPlayerChar || isAIThinking()) {
+        return false;
     }
     
+    clearPonderedReplies();
+    stopPonder.store(false);
+    SearchLimits limits = moveLimits();
+    limits.stop = &stopPonder;
+    pondering = std::async(std::launch::async, &Game::ponder, this, state.getBoard(), limits, collectSearchStats);
     return true;
 }
 
+void Game::stopPondering() {
+    if (!isPondering()) {
+        return;
+    }
+    stopPonder.store(true);
+    pondering.wait();
+    pondering = std::future<void>();
+}
+
+bool Game::isPondering() const {
+    return pondering.valid();
+}
+
+void Game::ponder(Board position, SearchLimits limits, bool collectStats) {
+    char human = (position.getMoveCount() % 2 == 0) ? 'X' : 'O';
+    
+    // Center columns first: they are the likeliest human moves
+    for (int i = 0; i < Board::COLS; i++) {
+        int col = Board::centerOutColumn(i);
+        Board next = position;
+        if (!next.dropPiece(col, human) || next.lastMoveWins() || next.isFull()) {
+            continue;
+        }
+        
+        PonderedReply& reply = ponderedReplies[col];
+        SearchStats stats;
+        int move = aiPlayer->selectMove(next, limits, collectStats ? &stats : nullptr);
+        
+        // An interrupted search's move must not be kept
+        if (stopPonder.load()) {
+            return;
+        }
+        reply.key = next.getKey();
+        reply.move = move;
+        reply.stats = stats;
+    }
+}
+
+SearchLimits Game::moveLimits() const {
+    SearchLimits limits = searchLimits;
+    if (aiDifficulty == AIDifficulty::PERFECT && limits.timeMs == 0 && limits.maxNodes == 0) {
+        limits.timeMs = PERFECT_MOVE_TIME_MS;
+    }
+    return limits;
+}
+
+bool Game::takePonderedReply(int& move) {
+    std::uint64_t key = state.getBoard().getKey();
+    for (PonderedReply& reply : ponderedReplies) {
+        if (reply.move >= 0 && reply.key == key) {
+            move = reply.move;
+            pendingSearchStats = reply.stats;
+            clearPonderedReplies();
+            return true;
+        }
+    }
+    return false;
+}
+
+void Game::clearPonderedReplies() {
+    for (PonderedReply& reply : ponderedReplies) {
+        reply = PonderedReply();
+    }
+}
+
+bool Game::makeMove(int column) {
+    stopPondering();
+    return state.makeMove(column);
+}
+
 void Game::reset() {
-    board.reset();
-    currentPlayer = 'X';
-    gameOver = false;
-    winner = ' ';
+    cancelAIMove();
+    state.reset();
     // Reinitialize AI if in AI mode
     if (gameMode == GameMode::PLAYER_VS_AI) {
         initializeAI();
@@ -109,19 +312,19 @@ void Game::reset() {
 }
 
 char Game::getCurrentPlayer() const {
-    return currentPlayer;
+    return state.getCurrentPlayer();
 }
 
 bool Game::isGameOver() const {
-    return gameOver;
+    return state.isGameOver();
 }
 
 char Game::getWinner() const {
-    return winner;
+    return state.getWinner();
 }
 
 const Board& Game::getBoard() const {
-    return board;
+    return state.getBoard();
 }
 
 void Game::start() {
@@ -134,16 +337,16 @@ void Game::start() {
     std::cout << "=================================\n\n";
     
     while (!isGameOver()) {
-        board.display();
+        state.getBoard().display();
         playTurn();
     }
     
-    board.display();
+    state.getBoard().display();
     displayWinner();
 }
 
 void Game::playTurn() {
-    std::cout << "\nPlayer " << currentPlayer << "'s turn.\n";
+    std::cout << "\nPlayer " << state.getCurrentPlayer() << "'s turn.\n";
     
     int column;
     bool validMove = false;
@@ -165,18 +368,14 @@ void Game::playTurn() {
 
 void Game::displayWinner() const {
     std::cout << "\n=================================\n";
-    if (winner == ' ') {
+    if (state.getWinner() == ' ') {
         std::cout << "  It's a draw!\n";
     } else {
-        std::cout << "  Player " << winner << " wins!\n";
+        std::cout << "  Player " << state.getWinner() << " wins!\n";
     }
     std::cout << "=================================\n";
 }
 
-void Game::switchPlayer() {
-    currentPlayer = (currentPlayer == 'X') ? 'O' : 'X';
-}
-
 int Game::getPlayerMove() const {
     int column;
     std::cout << "Enter column (1-7): ";
@@ -0,0 +1,216 @@
+#include "GameRecord.h"
+#include "BitUtils.h"
+#include <algorithm>
+
+namespace {
+
+const unsigned char MAGIC[4] = {'C', '4', 'G', 'R'};
+const std::size_t HEADER_SIZE = 16;
+const std::size_t RECORD_HEADER_SIZE = 2;
+
+// Buffered bytes that trigger a write to the file
+const std::size_t FLUSH_THRESHOLD = 1 << 16;
+
+// Bits needed to store any column index
+int bitsPerMove(int cols) {
+    int bits = 1;
+    while ((1 << bits) < cols) {
+        bits++;
+    }
+    return bits;
+}
+
+std::size_t packedSize(int moveCount, int moveBits) {
+    return (static_cast<std::size_t>(moveCount) * moveBits + 7) / 8;
+}
+
+bool isValidResult(char result) {
+    return result == 'X' || result == 'O' || result == ' ' || result == '?';
+}
+
+} // namespace
+
+GameRecordWriter::GameRecordWriter() : gameCount(0), cols(0), cells(0), moveBits(0) {}
+
+GameRecordWriter::~GameRecordWriter() {
+    close();
+}
+
+bool GameRecordWriter::open(const std::string& path, int rows, int cols, int connect) {
+    close();
+    if (rows <= 0 || cols <= 0 || rows * cols > MAX_BOARD_CELLS || connect <= 0) {
+        return false;
+    }
+
+    out.open(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        return false;
+    }
+
+    // The game count is patched in by close()
+    unsigned char header[HEADER_SIZE];
+    std::copy(MAGIC, MAGIC + 4, header);
+    header[4] = GameRecord::FORMAT_VERSION;
+    header[5] = static_cast<unsigned char>(rows);
+    header[6] = static_cast<unsigned char>(cols);
+    header[7] = static_cast<unsigned char>(connect);
+    writeLittleEndian64(header + 8, 0);
+    out.write(reinterpret_cast<const char*>(header), HEADER_SIZE);
+
+    buffer.clear();
+    buffer.reserve(FLUSH_THRESHOLD + RECORD_HEADER_SIZE + packedSize(MAX_BOARD_CELLS, 7));
+    gameCount = 0;
+    this->cols = cols;
+    cells = rows * cols;
+    moveBits = bitsPerMove(cols);
+    return static_cast<bool>(out);
+}
+
+bool GameRecordWriter::write(const int* moves, int moveCount, char result) {
+    if (!out.is_open() || moveCount < 0 || moveCount > cells || !isValidResult(result)) {
+        return false;
+    }
+
+    std::size_t start = buffer.size();
+    buffer.resize(start + RECORD_HEADER_SIZE + packedSize(moveCount, moveBits));
+    unsigned char* record = buffer.data() + start;
+    record[0] = static_cast<unsigned char>(moveCount);
+    record[1] = static_cast<unsigned char>(result);
+
+    // Shift moves into an accumulator and emit whole bytes as they fill up
+    unsigned char* packed = record + RECORD_HEADER_SIZE;
+    std::uint32_t bits = 0;
+    int bitCount = 0;
+    for (int ply = 0; ply < moveCount; ply++) {
+        if (moves[ply] < 0 || moves[ply] >= cols) {
+            buffer.resize(start);
+            return false;
+        }
+        bits |= static_cast<std::uint32_t>(moves[ply]) << bitCount;
+        bitCount += moveBits;
+        while (bitCount >= 8) {
+            *packed++ = static_cast<unsigned char>(bits);
+            bits >>= 8;
+            bitCount -= 8;
+        }
+    }
+    if (bitCount > 0) {
+        *packed = static_cast<unsigned char>(bits);
+    }
+
+    gameCount++;
+    return buffer.size() < FLUSH_THRESHOLD || flush();
+}
+
+bool GameRecordWriter::close() {
+    if (!out.is_open()) {
+        return true;
+    }
+
+    flush();
+    unsigned char count[8];
+    writeLittleEndian64(count, gameCount);
+    out.seekp(8);
+    out.write(reinterpret_cast<const char*>(count), sizeof(count));
+    bool ok = static_cast<bool>(out);
+    out.close();
+    return ok;
+}
+
+bool GameRecordWriter::isOpen() const {
+    return out.is_open();
+}
+
+std::uint64_t GameRecordWriter::size() const {
+    return gameCount;
+}
+
+bool GameRecordWriter::flush() {
+    out.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+    buffer.clear();
+    return static_cast<bool>(out);
+}
+
+GameRecordReader::GameRecordReader()
+    : offset(HEADER_SIZE), gameCount(0), rows(0), cols(0), connect(0), moveBits(0) {}
+
+bool GameRecordReader::open(const std::string& path) {
+    close();
+    if (!file.open(path)) {
+        return false;
+    }
+
+    const unsigned char* header = file.data();
+    bool valid = file.size() >= HEADER_SIZE &&
+                 std::equal(MAGIC, MAGIC + 4, header) &&
+                 header[4] == GameRecord::FORMAT_VERSION &&
+                 header[5] > 0 && header[6] > 0 && header[7] > 0 &&
+                 header[5] * header[6] <= MAX_BOARD_CELLS;
+    if (!valid) {
+        close();
+        return false;
+    }
+
+    rows = header[5];
+    cols = header[6];
+    connect = header[7];
+    moveBits = bitsPerMove(cols);
+    gameCount = readLittleEndian64(header + 8);
+    offset = HEADER_SIZE;
+    return true;
+}
+
+void GameRecordReader::close() {
+    file.close();
+    offset = HEADER_SIZE;
+    gameCount = 0;
+    rows = 0;
+    cols = 0;
+    connect = 0;
+    moveBits = 0;
+}
+
+bool GameRecordReader::isOpen() const {
+    return file.isOpen();
+}
+
+std::uint64_t GameRecordReader::size() const {
+    return gameCount;
+}
+
+int GameRecordReader::getRows() const {
+    return rows;
+}
+
+int GameRecordReader::getCols() const {
+    return cols;
+}
+
+int GameRecordReader::getConnect() const {
+    return connect;
+}
+
+bool GameRecordReader::next(GameRecord& record) {
+    if (!file.isOpen() || file.size() - offset < RECORD_HEADER_SIZE) {
+        return false;
+    }
+
+    const unsigned char* data = file.data() + offset;
+    int moveCount = data[0];
+    std::size_t recordSize = RECORD_HEADER_SIZE + packedSize(moveCount, moveBits);
+    if (moveCount > rows * cols || !isValidResult(static_cast<char>(data[1])) ||
+        file.size() - offset < recordSize) {
+        return false;
+    }
+
+    record.packedMoves = data + RECORD_HEADER_SIZE;
+    record.moveCount = moveCount;
+    record.moveBits = moveBits;
+    record.result = static_cast<char>(data[1]);
+    offset += recordSize;
+    return true;
+}
+
+void GameRecordReader::rewind() {
+    offset = HEADER_SIZE;
+}
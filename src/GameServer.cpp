@@ -0,0 +1,205 @@
+#include "GameServer.h"
+#include "AIPlayer.h"
+#include <algorithm>
+#include <memory>
+
+namespace {
+
+// Engines a worker keeps, one per engine kind and color
+const int ENGINE_KINDS = 3;
+
+} // namespace
+
+GameServer::GameServer(const GameServerConfig& config)
+    : config(config), sessions(config.maxSessions), pendingMoves(0), stopping(false) {
+    int threads = config.aiThreads;
+    if (threads <= 0) {
+        threads = static_cast<int>(std::thread::hardware_concurrency());
+        if (threads <= 0) {
+            threads = 1;
+        }
+    }
+
+    activeSearches = std::make_unique<ActiveSearch[]>(threads);
+    for (int i = 0; i < threads; i++) {
+        workers.emplace_back(&GameServer::workerLoop, this, i);
+    }
+}
+
+GameServer::~GameServer() {
+    {
+        std::lock_guard<std::mutex> lock(requestMutex);
+        stopping = true;
+        requests.clear();
+        for (std::size_t i = 0; i < workers.size(); i++) {
+            activeSearches[i].stop.store(true, std::memory_order_relaxed);
+        }
+    }
+    requestAvailable.notify_all();
+
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+SessionHandle GameServer::createSession(const EngineSpec& engine, char aiPlayer) {
+    if (aiPlayer != 'X' && aiPlayer != 'O' && aiPlayer != ' ') {
+        return SessionHandle();
+    }
+
+    SessionHandle handle = sessions.allocate();
+    GameSession* session = sessions.get(handle);
+    if (!session) {
+        return handle;
+    }
+
+    session->engine = engine;
+    session->aiPlayer = aiPlayer;
+    if (aiPlayer == 'X') {
+        requestAIMove(handle, *session);
+    }
+    return handle;
+}
+
+bool GameServer::closeSession(SessionHandle session) {
+    const GameSession* closing = sessions.get(session);
+    if (closing && closing->aiThinking) {
+        pendingMoves--;
+
+        // Nobody is waiting for the move any more
+        std::lock_guard<std::mutex> lock(requestMutex);
+        requests.erase(std::remove_if(requests.begin(), requests.end(),
+                                      [session](const AIRequest& request) { return request.session == session; }),
+                       requests.end());
+        for (std::size_t i = 0; i < workers.size(); i++) {
+            if (activeSearches[i].session == session) {
+                activeSearches[i].stop.store(true, std::memory_order_relaxed);
+            }
+        }
+    }
+    return sessions.release(session);
+}
+
+const GameSession* GameServer::getSession(SessionHandle session) const {
+    return sessions.get(session);
+}
+
+bool GameServer::makeMove(SessionHandle handle, int column) {
+    GameSession* session = sessions.get(handle);
+    if (!session || session->aiThinking || session->state.getCurrentPlayer() == session->aiPlayer) {
+        return false;
+    }
+    GameState state = session->state.unpack();
+    if (!state.makeMove(column)) {
+        return false;
+    }
+    session->state = PackedGameState(state);
+
+    if (!state.isGameOver() && state.getCurrentPlayer() == session->aiPlayer) {
+        requestAIMove(handle, *session);
+    }
+    return true;
+}
+
+std::size_t GameServer::pollAIMoves(std::vector<AIMove>& applied) {
+    applied.clear();
+    collected.clear();
+    {
+        std::lock_guard<std::mutex> lock(resultMutex);
+        collected.swap(results);
+    }
+
+    for (const AIResult& result : collected) {
+        // The session may have been closed, or its slot reused, meanwhile
+        GameSession* session = sessions.get(result.session);
+        if (!session || !session->aiThinking ||
+            session->state.getMoveCount() != result.moveCount) {
+            continue;
+        }
+
+        session->aiThinking = false;
+        pendingMoves--;
+        GameState state = session->state.unpack();
+        if (state.makeMove(result.column)) {
+            session->state = PackedGameState(state);
+            applied.push_back(AIMove{result.session, result.column});
+        } else {
+            // Asking the same engine again would likely fail the same way
+            applied.push_back(AIMove{result.session, NO_MOVE});
+        }
+    }
+    return applied.size();
+}
+
+void GameServer::setAIMoveNotifier(std::function<void()> notifier) {
+    this->notifier = std::move(notifier);
+}
+
+std::size_t GameServer::sessionCount() const {
+    return sessions.size();
+}
+
+std::size_t GameServer::pendingAIMoveCount() const {
+    return pendingMoves;
+}
+
+int GameServer::workerCount() const {
+    return static_cast<int>(workers.size());
+}
+
+void GameServer::requestAIMove(SessionHandle handle, GameSession& session) {
+    session.aiThinking = true;
+    pendingMoves++;
+    {
+        std::lock_guard<std::mutex> lock(requestMutex);
+        requests.push_back(AIRequest{handle, session.state.unpack().getBoard(), session.engine, session.aiPlayer});
+    }
+    requestAvailable.notify_one();
+}
+
+void GameServer::workerLoop(int index) {
+    // Created on first use, so workers only hold tables for engines in play
+    std::unique_ptr<AIPlayer> engines[ENGINE_KINDS][2];
+    std::uint32_t seed = static_cast<std::uint32_t>(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    ActiveSearch& active = activeSearches[index];
+
+    while (true) {
+        AIRequest request;
+        {
+            std::unique_lock<std::mutex> lock(requestMutex);
+            active.session = SessionHandle();
+            requestAvailable.wait(lock, [this]() { return stopping || !requests.empty(); });
+            if (stopping) {
+                return;
+            }
+            request = requests.front();
+            requests.pop_front();
+            active.session = request.session;
+            active.stop.store(false, std::memory_order_relaxed);
+        }
+
+        std::unique_ptr<AIPlayer>& engine =
+            engines[static_cast<int>(request.engine.kind)][request.player == 'X' ? 0 : 1];
+        if (!engine) {
+            engine = request.engine.create(request.player, config.ttSizeMB, seed++);
+        }
+
+        SearchLimits limits = config.limits;
+        limits.maxDepth = request.engine.depth;
+        limits.stop = &active.stop;
+        int column = engine->selectMove(request.board, limits);
+
+        // A stopped search's move is meaningless, and nobody wants it
+        if (active.stop.load(std::memory_order_relaxed)) {
+            continue;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(resultMutex);
+            results.push_back(AIResult{request.session, request.board.getMoveCount(), column});
+        }
+        if (notifier) {
+            notifier();
+        }
+    }
+}
@@ -0,0 +1,95 @@
+#include "GameState.h"
+
+GameState::GameState() : currentPlayer('X'), gameOver(false), winner(' ') {}
+
+bool GameState::makeMove(int column) {
+    if (gameOver) {
+        return false;
+    }
+
+    if (!board.dropPiece(column, currentPlayer)) {
+        return false;
+    }
+
+    // Only the piece just dropped can have completed a line
+    if (board.lastMoveWins()) {
+        gameOver = true;
+        winner = currentPlayer;
+    } else if (board.isFull()) {
+        gameOver = true;
+        winner = ' ';
+    } else {
+        currentPlayer = (currentPlayer == 'X') ? 'O' : 'X';
+    }
+
+    return true;
+}
+
+void GameState::reset() {
+    board.reset();
+    currentPlayer = 'X';
+    gameOver = false;
+    winner = ' ';
+}
+
+char GameState::getCurrentPlayer() const {
+    return currentPlayer;
+}
+
+bool GameState::isGameOver() const {
+    return gameOver;
+}
+
+char GameState::getWinner() const {
+    return winner;
+}
+
+const Board& GameState::getBoard() const {
+    return board;
+}
+
+PackedGameState::PackedGameState() : PackedGameState(GameState()) {}
+
+PackedGameState::PackedGameState(const GameState& state)
+    : moveCount(static_cast<std::uint8_t>(state.board.getMoveCount())),
+      lastMove(static_cast<std::int8_t>(state.board.getMove(state.board.getMoveCount() - 1))),
+      currentPlayer(state.currentPlayer), gameOver(state.gameOver), winner(state.winner) {
+    pieces[0] = state.board.getPlayerMask('X');
+    pieces[1] = state.board.getPlayerMask('O');
+}
+
+GameState PackedGameState::unpack() const {
+    GameState state;
+    state.board = Board::fromMasks(pieces[0], pieces[1], lastMove);
+    state.currentPlayer = currentPlayer;
+    state.gameOver = gameOver;
+    state.winner = winner;
+    return state;
+}
+
+Board::Bitboard PackedGameState::getPlayerMask(char player) const {
+    if (player == 'X') {
+        return pieces[0];
+    }
+    return player == 'O' ? pieces[1] : Board::Bitboard(0);
+}
+
+int PackedGameState::getMoveCount() const {
+    return moveCount;
+}
+
+int PackedGameState::getLastMove() const {
+    return lastMove;
+}
+
+char PackedGameState::getCurrentPlayer() const {
+    return currentPlayer;
+}
+
+bool PackedGameState::isGameOver() const {
+    return gameOver;
+}
+
+char PackedGameState::getWinner() const {
+    return winner;
+}
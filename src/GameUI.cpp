@@ -1,11 +1,15 @@
 #include "GameUI.h"
 #include <iostream>
 #include <cmath>
+#include <utility>
 
 GameUI::GameUI() 
-    : window(nullptr), renderer(nullptr), font(nullptr), 
+    : window(nullptr), renderer(nullptr), font(nullptr), circleTexture(nullptr),
       hoveredColumn(-1), showWinMessage(false), 
       uiState(UIState::MODE_SELECTION),
+      aiTurnStart(0), thinkingDots(0),
+      needsRedraw(true), continuousRendering(false), showFrameStats(false),
+      redrawCount(0), lastFrameMs(0.0),
       selectedGameMode(GameMode::PLAYER_VS_PLAYER),
       selectedAIDifficulty(AIDifficulty::MEDIUM),
       selectedMinimaxDepth(4) {}
@@ -55,6 +59,9 @@ bool GameUI::init() {
         return false;
     }
     
+    // Pieces and holes are all copies of one pre-rendered disc
+    createCircleTexture();
+    
     // Load font - try to use a system font
     font = TTF_OpenFont("/usr/share/fonts/truetype/dejavu/DejaVuSans-Bold.ttf", 24);
     if (!font) {
@@ -73,19 +80,45 @@ bool GameUI::init() {
     return true;
 }
 
+bool GameUI::loadOpeningBook(const std::string& path) {
+    return game.setOpeningBook(path);
+}
+
+void GameUI::setContinuousRendering(bool enabled) {
+    continuousRendering = enabled;
+}
+
 void GameUI::run() {
     bool running = true;
     
     while (running) {
         handleEvents(running);
         update();
-        render();
         
-        SDL_Delay(16); // Cap at ~60 FPS
+        if (needsRedraw || continuousRendering) {
+            Uint64 frameStart = SDL_GetPerformanceCounter();
+            render();
+            lastFrameMs = 1000.0 * static_cast<double>(SDL_GetPerformanceCounter() - frameStart) /
+                          static_cast<double>(SDL_GetPerformanceFrequency());
+            redrawCount++;
+            needsRedraw = false;
+        }
+        
+        if (continuousRendering) {
+            SDL_Delay(16); // Cap at ~60 FPS
+        } else if (running) {
+            // Sleep until the next event; while the AI thinks, wake up
+            // regularly to collect its move and animate the turn label
+            int timeout = game.isAIThinking() ? THINKING_WAIT_MS : IDLE_WAIT_MS;
+            SDL_WaitEventTimeout(nullptr, timeout);
+        }
     }
 }
 
 void GameUI::cleanup() {
+    // Textures belong to the renderer, so they go first
+    clearTextureCache();
+    
     if (font) {
         TTF_CloseFont(font);
         font = nullptr;
@@ -114,13 +147,30 @@ void GameUI::handleEvents(bool& running) {
                 running = false;
                 break;
                 
+            case SDL_WINDOWEVENT:
+                // Exposed, resized, restored...: the window contents may be gone
+                needsRedraw = true;
+                break;
+                
+            case SDL_KEYDOWN:
+                if (event.key.keysym.sym == SDLK_F3 && !event.key.repeat) {
+                    showFrameStats = !showFrameStats;
+                    needsRedraw = true;
+                }
+                break;
+                
             case SDL_MOUSEMOTION:
                 if (uiState == UIState::PLAYING) {
-                    hoveredColumn = getColumnFromMouseX(event.motion.x);
+                    int column = getColumnFromMouseX(event.motion.x);
+                    if (column != hoveredColumn) {
+                        hoveredColumn = column;
+                        needsRedraw = true;
+                    }
                 }
                 break;
                 
             case SDL_MOUSEBUTTONDOWN:
+                needsRedraw = true;
                 if (event.button.button == SDL_BUTTON_LEFT) {
                     int mouseX = event.button.x;
                     int mouseY = event.button.y;
@@ -168,15 +218,34 @@ void GameUI::handleEvents(bool& running) {
 }
 
 void GameUI::update() {
-    // Handle AI moves in AI mode
+    // Handle AI moves in AI mode; the search runs in the background so the
+    // window keeps drawing and responding while the AI thinks
     if (uiState == UIState::PLAYING && game.isAITurn() && !game.isGameOver()) {
-        // Add a small delay so AI moves are visible
-        SDL_Delay(500);
-        game.makeAIMove();
-        if (game.isGameOver()) {
-            showWinMessage = true;
+        if (!game.isAIThinking()) {
+            game.beginAIMove();
+            aiTurnStart = SDL_GetTicks();
+            thinkingDots = getThinkingDots();
+            needsRedraw = true;
+            return;
+        }
+        
+        // Hold back fast moves for a moment so they are visible
+        if (SDL_GetTicks() - aiTurnStart >= AI_MOVE_DELAY_MS && game.pollAIMove()) {
+            if (game.isGameOver()) {
+                showWinMessage = true;
+            }
+            needsRedraw = true;
+        } else if (getThinkingDots() != thinkingDots) {
+            thinkingDots = getThinkingDots();
+            needsRedraw = true;
         }
     }
+    
+    // While the human decides, let the AI search its replies; clicking a
+    // column stops this before the piece is dropped
+    if (uiState == UIState::PLAYING && !game.isAITurn() && !game.isGameOver()) {
+        game.startPondering();
+    }
 }
 
 void GameUI::render() {
@@ -198,6 +267,10 @@ void GameUI::render() {
         }
     }
     
+    if (showFrameStats) {
+        renderFrameStats();
+    }
+    
     // Present
     SDL_RenderPresent(renderer);
 }
@@ -274,6 +347,9 @@ void GameUI::renderPlayerTurn() {
         } else {
             snprintf(turnText, sizeof(turnText), "Player %c Wins!", winner);
         }
+    } else if (game.isAIThinking()) {
+        snprintf(turnText, sizeof(turnText), "Player %c is thinking%.*s",
+                 game.getCurrentPlayer(), getThinkingDots(), "...");
     } else {
         snprintf(turnText, sizeof(turnText), "Player %c's Turn", game.getCurrentPlayer());
     }
@@ -282,6 +358,18 @@ void GameUI::renderPlayerTurn() {
     renderText(turnText, WINDOW_WIDTH / 2 - 100, 30, textColor);
 }
 
+void GameUI::renderFrameStats() {
+    if (!font) return;
+    
+    // Time of the previous frame: this one is still being drawn
+    char statsText[64];
+    snprintf(statsText, sizeof(statsText), "%.2f ms/frame, %u redraws%s", lastFrameMs,
+             static_cast<unsigned>(redrawCount), continuousRendering ? " (continuous)" : "");
+    
+    SDL_Color textColor = {90, 90, 90, 255};
+    renderUncachedText(statsText, 10, WINDOW_HEIGHT - 34, textColor);
+}
+
 void GameUI::renderWinMessage() {
     if (!font) return;
     
@@ -341,6 +429,11 @@ int GameUI::getColumnFromMouseX(int mouseX) {
     return (mouseX - BOARD_OFFSET_X) / CELL_SIZE;
 }
 
+int GameUI::getThinkingDots() const {
+    // Cycle through one to three dots while the AI searches
+    return static_cast<int>((SDL_GetTicks() - aiTurnStart) / 400 % 3) + 1;
+}
+
 bool GameUI::isMouseOverNewGameButton(int mouseX, int mouseY) {
     return mouseX >= WINDOW_WIDTH / 2 - BUTTON_WIDTH / 2 && 
            mouseX <= WINDOW_WIDTH / 2 + BUTTON_WIDTH / 2 &&
@@ -361,6 +454,17 @@ bool GameUI::isMouseOverBackButton(int mouseX, int mouseY) {
 }
 
 void GameUI::drawFilledCircle(int centerX, int centerY, int radius, SDL_Color color) {
+    if (circleTexture) {
+        // Tint the white disc; other radii scale it
+        int size = 2 * radius + 1;
+        SDL_Rect destRect = {centerX - radius, centerY - radius, size, size};
+        SDL_SetTextureColorMod(circleTexture, color.r, color.g, color.b);
+        SDL_SetTextureAlphaMod(circleTexture, color.a);
+        SDL_RenderCopy(renderer, circleTexture, nullptr, &destRect);
+        return;
+    }
+    
+    // Fallback if the disc texture couldn't be created: one point per pixel
     SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
     
     for (int w = 0; w < radius * 2; w++) {
@@ -394,22 +498,112 @@ void GameUI::drawButton(int x, int y, int width, int height, const char* text, S
 void GameUI::renderText(const char* text, int x, int y, SDL_Color color) {
     if (!font) return;
     
+    const TextTexture* cached = getTextTexture(text, color);
+    if (!cached) {
+        return;
+    }
+    
+    SDL_Rect destRect = {x, y, cached->width, cached->height};
+    SDL_RenderCopy(renderer, cached->texture, nullptr, &destRect);
+}
+
+void GameUI::renderUncachedText(const char* text, int x, int y, SDL_Color color) {
+    // For text that changes every frame and would only churn the cache
     SDL_Surface* surface = TTF_RenderText_Solid(font, text, color);
     if (!surface) {
         return;
     }
     
     SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-    if (!texture) {
-        SDL_FreeSurface(surface);
+    if (texture) {
+        SDL_Rect destRect = {x, y, surface->w, surface->h};
+        SDL_RenderCopy(renderer, texture, nullptr, &destRect);
+        SDL_DestroyTexture(texture);
+    }
+    SDL_FreeSurface(surface);
+}
+
+void GameUI::createCircleTexture() {
+    int size = 2 * PIECE_RADIUS + 1;
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, size, size, 32, SDL_PIXELFORMAT_RGBA32);
+    if (!surface) {
         return;
     }
     
-    SDL_Rect destRect = {x, y, surface->w, surface->h};
-    SDL_RenderCopy(renderer, texture, nullptr, &destRect);
+    // Opaque white inside the circle, transparent outside
+    Uint32 inside = SDL_MapRGBA(surface->format, 255, 255, 255, 255);
+    Uint32 outside = SDL_MapRGBA(surface->format, 255, 255, 255, 0);
+    SDL_LockSurface(surface);
+    for (int y = 0; y < size; y++) {
+        Uint32* row = reinterpret_cast<Uint32*>(static_cast<Uint8*>(surface->pixels) + y * surface->pitch);
+        int dy = y - PIECE_RADIUS;
+        for (int x = 0; x < size; x++) {
+            int dx = x - PIECE_RADIUS;
+            row[x] = (dx * dx + dy * dy <= PIECE_RADIUS * PIECE_RADIUS) ? inside : outside;
+        }
+    }
+    SDL_UnlockSurface(surface);
     
-    SDL_DestroyTexture(texture);
+    circleTexture = SDL_CreateTextureFromSurface(renderer, surface);
     SDL_FreeSurface(surface);
+    if (circleTexture) {
+        SDL_SetTextureBlendMode(circleTexture, SDL_BLENDMODE_BLEND);
+    }
+}
+
+const GameUI::TextTexture* GameUI::getTextTexture(const char* text, SDL_Color color) {
+    // Hashing the text in place (FNV-1a, seeded with the color) keeps
+    // lookups free of allocations; a string is only stored on a miss
+    Uint32 packedColor = static_cast<Uint32>(color.r) << 24 | static_cast<Uint32>(color.g) << 16 |
+                         static_cast<Uint32>(color.b) << 8 | color.a;
+    Uint64 key = 14695981039346656037ull ^ packedColor;
+    for (const char* c = text; *c; c++) {
+        key = (key ^ static_cast<unsigned char>(*c)) * 1099511628211ull;
+    }
+    
+    auto it = textCache.find(key);
+    if (it != textCache.end()) {
+        if (it->second.color == packedColor && it->second.text == text) {
+            return &it->second;
+        }
+        // Another text with the same hash: replace it
+        SDL_DestroyTexture(it->second.texture);
+        textCache.erase(it);
+    }
+    
+    SDL_Surface* surface = TTF_RenderText_Solid(font, text, color);
+    if (!surface) {
+        return nullptr;
+    }
+    
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+    TextTexture entry = {texture, surface->w, surface->h, text, packedColor};
+    SDL_FreeSurface(surface);
+    if (!texture) {
+        return nullptr;
+    }
+    
+    // Texts are a small fixed set plus a few numbers, but don't let a
+    // changing string grow the cache without bound
+    if (textCache.size() >= MAX_CACHED_TEXTS) {
+        for (auto& cached : textCache) {
+            SDL_DestroyTexture(cached.second.texture);
+        }
+        textCache.clear();
+    }
+    return &textCache.emplace(key, std::move(entry)).first->second;
+}
+
+void GameUI::clearTextureCache() {
+    for (auto& cached : textCache) {
+        SDL_DestroyTexture(cached.second.texture);
+    }
+    textCache.clear();
+    
+    if (circleTexture) {
+        SDL_DestroyTexture(circleTexture);
+        circleTexture = nullptr;
+    }
 }
 
 void GameUI::renderModeSelection() {
@@ -437,10 +631,12 @@ void GameUI::renderModeSelection() {
         SDL_Color easyColor = (selectedAIDifficulty == AIDifficulty::EASY) ? selectedColor : buttonColor;
         SDL_Color medColor = (selectedAIDifficulty == AIDifficulty::MEDIUM) ? selectedColor : buttonColor;
         SDL_Color hardColor = (selectedAIDifficulty == AIDifficulty::HARD) ? selectedColor : buttonColor;
+        SDL_Color perfectColor = (selectedAIDifficulty == AIDifficulty::PERFECT) ? selectedColor : buttonColor;
         
         drawButton(100, 260, 150, 50, "Easy", easyColor);
         drawButton(270, 260, 150, 50, "Medium", medColor);
         drawButton(440, 260, 150, 50, "Hard", hardColor);
+        drawButton(610, 260, 150, 50, "Perfect", perfectColor);
         
         // Show depth slider for Hard mode
         if (selectedAIDifficulty == AIDifficulty::HARD) {
@@ -486,6 +682,8 @@ void GameUI::handleModeSelectionClick(int mouseX, int mouseY) {
             selectedAIDifficulty = AIDifficulty::MEDIUM;
         } else if (isMouseOverHardButton(mouseX, mouseY)) {
             selectedAIDifficulty = AIDifficulty::HARD;
+        } else if (isMouseOverPerfectButton(mouseX, mouseY)) {
+            selectedAIDifficulty = AIDifficulty::PERFECT;
         }
         
         // Check depth slider (only for Hard mode)
@@ -528,6 +726,10 @@ bool GameUI::isMouseOverHardButton(int mouseX, int mouseY) {
     return mouseX >= 440 && mouseX <= 590 && mouseY >= 260 && mouseY <= 310;
 }
 
+bool GameUI::isMouseOverPerfectButton(int mouseX, int mouseY) {
+    return mouseX >= 610 && mouseX <= 760 && mouseY >= 260 && mouseY <= 310;
+}
+
 bool GameUI::isMouseOverStartButton(int mouseX, int mouseY) {
     return mouseX >= WINDOW_WIDTH / 2 - 100 && mouseX <= WINDOW_WIDTH / 2 + 100 &&
            mouseY >= WINDOW_HEIGHT - 150 && mouseY <= WINDOW_HEIGHT - 90;
@@ -0,0 +1,164 @@
+#include "IncrementalEvaluator.h"
+
+namespace {
+
+/**
+ * Windows each cell belongs to, with cells numbered col * ROWS + height
+ * (height counted from the bottom) and windows numbered in the order they
+ * are generated below. Built at compile time.
+ */
+template <typename BoardT>
+struct CellWindowTable {
+    static constexpr int ROWS = BoardT::ROWS;
+    static constexpr int COLS = BoardT::COLS;
+    static constexpr int K = BoardT::CONNECT;
+    static constexpr int CELLS = ROWS * COLS;
+
+    // A cell lies in at most K windows per direction (13 in all for K = 4)
+    static constexpr int MAX_WINDOWS_PER_CELL = 4 * K;
+
+    std::uint8_t windows[CELLS][MAX_WINDOWS_PER_CELL] = {};
+    std::uint8_t counts[CELLS] = {};
+
+    constexpr CellWindowTable() {
+        // Vertical, diagonal (\), horizontal and diagonal (/)
+        const int colSteps[4] = {0, 1, 1, 1};
+        const int heightSteps[4] = {1, -1, 0, 1};
+
+        int window = 0;
+        for (int dir = 0; dir < 4; dir++) {
+            for (int col = 0; col < COLS; col++) {
+                for (int height = 0; height < ROWS; height++) {
+                    int lastCol = col + (K - 1) * colSteps[dir];
+                    int lastHeight = height + (K - 1) * heightSteps[dir];
+                    if (lastCol >= COLS || lastHeight < 0 || lastHeight >= ROWS) {
+                        continue;
+                    }
+
+                    for (int i = 0; i < K; i++) {
+                        int cell = (col + i * colSteps[dir]) * ROWS + height + i * heightSteps[dir];
+                        windows[cell][counts[cell]++] = static_cast<std::uint8_t>(window);
+                    }
+                    window++;
+                }
+            }
+        }
+    }
+};
+
+template <typename BoardT>
+constexpr CellWindowTable<BoardT> CELL_WINDOWS{};
+
+/**
+ * Score change of a window when a piece is added to it, by window state
+ * (aiCount + (K + 1) * humanCount) before the drop; taking the piece back
+ * subtracts the same amount
+ */
+template <int K>
+struct ScoreDeltaTable {
+    static constexpr int HUMAN_STEP = K + 1;
+    static constexpr int STATE_COUNT = HUMAN_STEP * HUMAN_STEP;
+
+    int aiPiece[STATE_COUNT] = {};
+    int humanPiece[STATE_COUNT] = {};
+
+    constexpr ScoreDeltaTable() {
+        for (int state = 0; state < STATE_COUNT; state++) {
+            int aiCount = state % HUMAN_STEP;
+            int humanCount = state / HUMAN_STEP;
+            int before = windowScore<K>(aiCount, humanCount);
+            aiPiece[state] = aiCount < K ? windowScore<K>(aiCount + 1, humanCount) - before : 0;
+            humanPiece[state] = humanCount < K ? windowScore<K>(aiCount, humanCount + 1) - before : 0;
+        }
+    }
+};
+
+template <int K>
+constexpr ScoreDeltaTable<K> SCORE_DELTAS{};
+
+// Center column preference per AI piece
+const int CENTER_SCORE = 3;
+
+} // namespace
+
+template <typename BoardT>
+BasicIncrementalEvaluator<BoardT>::MoveGuard::MoveGuard(BasicIncrementalEvaluator& evaluator, int column,
+                                                        int height, bool aiPiece)
+    : evaluator(evaluator), column(column), height(height), aiPiece(aiPiece) {
+    evaluator.addPiece(column, height, aiPiece);
+}
+
+template <typename BoardT>
+BasicIncrementalEvaluator<BoardT>::MoveGuard::~MoveGuard() {
+    evaluator.removePiece(column, height, aiPiece);
+}
+
+template <typename BoardT>
+BasicIncrementalEvaluator<BoardT>::BasicIncrementalEvaluator() : total(0) {
+    for (int i = 0; i < WINDOW_COUNT; i++) {
+        windowStates[i] = 0;
+    }
+}
+
+template <typename BoardT>
+void BasicIncrementalEvaluator<BoardT>::reset(const BoardT& board, char aiPlayer) {
+    for (int i = 0; i < WINDOW_COUNT; i++) {
+        windowStates[i] = 0;
+    }
+    total = 0;
+
+    for (int col = 0; col < BoardT::COLS; col++) {
+        for (int height = 0; height < board.getColumnHeight(col); height++) {
+            char cell = board.getCell(BoardT::ROWS - 1 - height, col);
+            addPiece(col, height, cell == aiPlayer);
+        }
+    }
+}
+
+template <typename BoardT>
+void BasicIncrementalEvaluator<BoardT>::addPiece(int column, int height, bool aiPiece) {
+    using Deltas = ScoreDeltaTable<BoardT::CONNECT>;
+    const CellWindowTable<BoardT>& table = CELL_WINDOWS<BoardT>;
+    int cell = column * BoardT::ROWS + height;
+    const int* deltas = aiPiece ? SCORE_DELTAS<BoardT::CONNECT>.aiPiece : SCORE_DELTAS<BoardT::CONNECT>.humanPiece;
+    int step = aiPiece ? 1 : Deltas::HUMAN_STEP;
+
+    for (int i = 0; i < table.counts[cell]; i++) {
+        std::uint8_t& state = windowStates[table.windows[cell][i]];
+        total += deltas[state];
+        state = static_cast<std::uint8_t>(state + step);
+    }
+
+    if (aiPiece && column == BoardT::COLS / 2) {
+        total += CENTER_SCORE;
+    }
+}
+
+template <typename BoardT>
+void BasicIncrementalEvaluator<BoardT>::removePiece(int column, int height, bool aiPiece) {
+    using Deltas = ScoreDeltaTable<BoardT::CONNECT>;
+    const CellWindowTable<BoardT>& table = CELL_WINDOWS<BoardT>;
+    int cell = column * BoardT::ROWS + height;
+    const int* deltas = aiPiece ? SCORE_DELTAS<BoardT::CONNECT>.aiPiece : SCORE_DELTAS<BoardT::CONNECT>.humanPiece;
+    int step = aiPiece ? 1 : Deltas::HUMAN_STEP;
+
+    for (int i = 0; i < table.counts[cell]; i++) {
+        std::uint8_t& state = windowStates[table.windows[cell][i]];
+        state = static_cast<std::uint8_t>(state - step);
+        total -= deltas[state];
+    }
+
+    if (aiPiece && column == BoardT::COLS / 2) {
+        total -= CENTER_SCORE;
+    }
+}
+
+template <typename BoardT>
+int BasicIncrementalEvaluator<BoardT>::score() const {
+    return total;
+}
+
+template class BasicIncrementalEvaluator<Board>;
+template class BasicIncrementalEvaluator<Board8x7>;
+template class BasicIncrementalEvaluator<Board9x7>;
+template class BasicIncrementalEvaluator<Board9x6Connect5>;
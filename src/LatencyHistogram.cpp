@@ -0,0 +1,104 @@
+#include "LatencyHistogram.h"
+#include "BitUtils.h"
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+const int SUB_BUCKET_COUNT = 1 << LatencyHistogram::SUB_BUCKET_BITS;
+const int HALF_COUNT = SUB_BUCKET_COUNT / 2;
+
+// Exact buckets below SUB_BUCKET_COUNT, then HALF_COUNT per remaining power of two
+const int BUCKET_COUNT = SUB_BUCKET_COUNT + (64 - LatencyHistogram::SUB_BUCKET_BITS) * HALF_COUNT;
+
+} // namespace
+
+LatencyHistogram::LatencyHistogram() : counts(BUCKET_COUNT, 0) {
+    reset();
+}
+
+void LatencyHistogram::record(std::uint64_t value) {
+    counts[bucketIndex(value)]++;
+    total++;
+    minValue = std::min(minValue, value);
+    maxValue = std::max(maxValue, value);
+    sum += static_cast<double>(value);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        counts[i] += other.counts[i];
+    }
+    total += other.total;
+    minValue = std::min(minValue, other.minValue);
+    maxValue = std::max(maxValue, other.maxValue);
+    sum += other.sum;
+}
+
+void LatencyHistogram::reset() {
+    std::fill(counts.begin(), counts.end(), 0);
+    total = 0;
+    minValue = std::numeric_limits<std::uint64_t>::max();
+    maxValue = 0;
+    sum = 0.0;
+}
+
+std::uint64_t LatencyHistogram::count() const {
+    return total;
+}
+
+std::uint64_t LatencyHistogram::min() const {
+    return total > 0 ? minValue : 0;
+}
+
+std::uint64_t LatencyHistogram::max() const {
+    return maxValue;
+}
+
+double LatencyHistogram::mean() const {
+    return total > 0 ? sum / static_cast<double>(total) : 0.0;
+}
+
+std::uint64_t LatencyHistogram::percentile(double percentile) const {
+    if (total == 0) {
+        return 0;
+    }
+
+    // Rank of the value sought, counting from 1
+    double clamped = std::min(std::max(percentile, 0.0), 100.0);
+    std::uint64_t rank = static_cast<std::uint64_t>(clamped / 100.0 * static_cast<double>(total) + 0.5);
+    rank = std::max<std::uint64_t>(rank, 1);
+
+    std::uint64_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        seen += counts[i];
+        if (seen >= rank) {
+            // The bucket bound may overshoot the largest value actually seen
+            return std::min(bucketHighest(i), maxValue);
+        }
+    }
+    return maxValue;
+}
+
+int LatencyHistogram::bucketIndex(std::uint64_t value) {
+    if (value < static_cast<std::uint64_t>(SUB_BUCKET_COUNT)) {
+        return static_cast<int>(value);
+    }
+
+    // The top SUB_BUCKET_BITS bits of the value select the bucket
+    int magnitude = highestBit64(value);
+    int shift = magnitude - (SUB_BUCKET_BITS - 1);
+    int top = static_cast<int>(value >> shift); // HALF_COUNT to SUB_BUCKET_COUNT - 1
+    return SUB_BUCKET_COUNT + (magnitude - SUB_BUCKET_BITS) * HALF_COUNT + (top - HALF_COUNT);
+}
+
+std::uint64_t LatencyHistogram::bucketHighest(int index) {
+    if (index < SUB_BUCKET_COUNT) {
+        return static_cast<std::uint64_t>(index);
+    }
+
+    int magnitude = SUB_BUCKET_BITS + (index - SUB_BUCKET_COUNT) / HALF_COUNT;
+    int shift = magnitude - (SUB_BUCKET_BITS - 1);
+    std::uint64_t top = static_cast<std::uint64_t>(HALF_COUNT + (index - SUB_BUCKET_COUNT) % HALF_COUNT);
+    return ((top + 1) << shift) - 1;
+}
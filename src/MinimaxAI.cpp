@@ -1,34 +1,485 @@
 #include "MinimaxAI.h"
+#include "BitUtils.h"
 #include <algorithm>
+#include <thread>
 
-MinimaxAI::MinimaxAI(int depth, char aiPlayer) 
-    : depth(depth), aiPlayer(aiPlayer) {
+namespace {
+
+// Scores beyond this magnitude are wins/losses rather than heuristic values
+const int WIN_THRESHOLD = 500000;
+
+// Distinguishes otherwise identical positions by the side to move
+const std::uint64_t MAXIMIZING_KEY_BIT = std::uint64_t(1) << 63;
+
+/**
+ * Transposition table key for a position and side to move. Keys that leave
+ * bit 63 free are used exactly; wider ones (128-bit boards) are hashed.
+ */
+template <typename BoardT>
+std::uint64_t tableKey(const BoardT& board, bool isMaximizing) {
+    std::uint64_t sideToMove = isMaximizing ? MAXIMIZING_KEY_BIT : 0;
+    if constexpr (BoardT::KEY_BITS < 64) {
+        return board.getKey() ^ sideToMove;
+    } else {
+        return hashKey(board.getKey()) ^ sideToMove;
+    }
+}
+
+// Win/loss scores encode the remaining depth at which they were found.
+// The table stores them relative to the node so they stay valid when the
+// same position is reached with a different remaining depth.
+int scoreToTable(int score, int currentDepth) {
+    if (score > WIN_THRESHOLD) {
+        return score - currentDepth;
+    }
+    if (score < -WIN_THRESHOLD) {
+        return score + currentDepth;
+    }
+    return score;
+}
+
+int scoreFromTable(int score, int currentDepth) {
+    if (score > WIN_THRESHOLD) {
+        return score + currentDepth;
+    }
+    if (score < -WIN_THRESHOLD) {
+        return score - currentDepth;
+    }
+    return score;
+}
+
+// Move ordering priorities; history scores are capped below the killers
+const int TT_MOVE_PRIORITY = 1 << 30;
+const int KILLER_PRIORITY = 1 << 29;
+const int HISTORY_MAX = KILLER_PRIORITY - 1;
+
+// Bit distance between neighbouring cells of a window, in the same order as
+// BasicBoard::hasLine: vertical, diagonal (\), horizontal and diagonal (/)
+template <typename BoardT>
+constexpr int windowShift(int dir) {
+    return dir == 0 ? 1 : BoardT::ROWS + dir - 1;
+}
+
+/**
+ * Precomputed masks for the bitboard evaluator, laid out like Board's
+ * bitboards (bit col * (ROWS + 1) + height, height counted from the bottom)
+ */
+template <typename BoardT>
+struct WindowTable {
+    using Bitboard = typename BoardT::Bitboard;
+
+    // Per direction, the first cell of every K-cell window that fits on
+    // the board; 69 windows in total on the standard board
+    Bitboard starts[4] = {};
+    Bitboard centerColumn = {};
+
+    constexpr WindowTable() {
+        // Column and height steps matching windowShift
+        const int colSteps[4] = {0, 1, 1, 1};
+        const int heightSteps[4] = {1, -1, 0, 1};
+        const int span = BoardT::CONNECT - 1;
+
+        for (int dir = 0; dir < 4; dir++) {
+            for (int col = 0; col < BoardT::COLS; col++) {
+                for (int height = 0; height < BoardT::ROWS; height++) {
+                    int lastCol = col + span * colSteps[dir];
+                    int lastHeight = height + span * heightSteps[dir];
+                    if (lastCol < BoardT::COLS && lastHeight >= 0 && lastHeight < BoardT::ROWS) {
+                        starts[dir] |= Bitboard(1) << (col * BoardT::COLUMN_BITS + height);
+                    }
+                }
+            }
+        }
+
+        centerColumn = BoardT::columnMask(BoardT::COLS / 2);
+    }
+};
+
+template <typename BoardT>
+constexpr WindowTable<BoardT> WINDOWS{};
+
+// Windows holding exactly K, K - 1 or K - 2 pieces, one bit per window
+template <typename Bitboard>
+struct WindowCounts {
+    Bitboard full;
+    Bitboard oneShort;
+    Bitboard twoShort;
+};
+
+// Binary digits needed to count up to n
+constexpr int countDigits(int n) {
+    int digits = 1;
+    while ((1 << digits) <= n) {
+        digits++;
+    }
+    return digits;
+}
+
+/**
+ * Bit-sliced count of the K cells of every window at once
+ * @param cells Pieces in the first cell of each window, then the following cells
+ */
+template <int K, typename Bitboard>
+WindowCounts<Bitboard> countWindows(const Bitboard (&cells)[K]) {
+    WindowCounts<Bitboard> counts;
+    if constexpr (K == 4) {
+        // Low two bits of the per-window sum (a sum of 4 wraps around to 0)
+        Bitboard low = cells[0] ^ cells[1] ^ cells[2] ^ cells[3];
+        Bitboard twos = (cells[0] & cells[1]) ^ (cells[2] & cells[3]) ^
+                        ((cells[0] ^ cells[1]) & (cells[2] ^ cells[3]));
+
+        counts.full = cells[0] & cells[1] & cells[2] & cells[3];
+        counts.oneShort = twos & low;
+        counts.twoShort = twos & ~low;
+    } else {
+        // Ripple-carry add of the cells into one bitboard per binary digit
+        const int digits = countDigits(K);
+        Bitboard sum[digits] = {};
+        for (const Bitboard& cell : cells) {
+            Bitboard carry = cell;
+            for (int d = 0; d < digits; d++) {
+                Bitboard next = sum[d] & carry;
+                sum[d] ^= carry;
+                carry = next;
+            }
+        }
+
+        auto exactly = [&sum](int n) {
+            Bitboard match = ~Bitboard(0);
+            for (int d = 0; d < digits; d++) {
+                match &= ((n >> d) & 1) ? sum[d] : ~sum[d];
+            }
+            return match;
+        };
+        counts.full = exactly(K);
+        counts.oneShort = exactly(K - 1);
+        counts.twoShort = exactly(K - 2);
+    }
+    return counts;
+}
+
+} // namespace
+
+template <typename BoardT>
+BasicMinimaxAI<BoardT>::BasicMinimaxAI(int depth, char aiPlayer, std::size_t ttSizeMB, int threads) 
+    : depth(depth), aiPlayer(aiPlayer), moveOrdering(true),
+      transpositionTable(ttSizeMB),
+      nodeLimit(0), hasDeadline(false), externalStop(nullptr), stopAll(false),
+      helperGeneration(0), helpersRunning(0), helpersShutdown(false), nextPosition(0) {
     // Determine the opponent's player character
     humanPlayer = (aiPlayer == 'X') ? 'O' : 'X';
+    
+    // The calling thread is the main worker; the rest are helpers
+    for (int i = 1; i < threads; i++) {
+        helperWorkers.push_back(std::make_unique<SearchWorker>());
+    }
+    for (std::size_t i = 0; i < helperWorkers.size(); i++) {
+        helperThreads.emplace_back(&BasicMinimaxAI::helperLoop, this, i);
+    }
 }
 
-int MinimaxAI::selectMove(const Board& board) {
-    // Make a copy of the board for simulation
-    Board tempBoard = board;
+template <typename BoardT>
+BasicMinimaxAI<BoardT>::~BasicMinimaxAI() {
+    {
+        std::lock_guard<std::mutex> lock(helperMutex);
+        helpersShutdown = true;
+    }
+    helperWake.notify_all();
+    for (std::thread& thread : helperThreads) {
+        thread.join();
+    }
+}
+
+template <typename BoardT>
+int BasicMinimaxAI<BoardT>::selectMove(const BoardT& board) {
+    SearchLimits limits;
+    limits.maxDepth = depth;
+    return selectMove(board, limits);
+}
+
+template <typename BoardT>
+int BasicMinimaxAI<BoardT>::selectMove(const BoardT& board, const SearchLimits& limits) {
+    return selectMove(board, limits, nullptr);
+}
+
+template <typename BoardT>
+int BasicMinimaxAI<BoardT>::selectMove(const BoardT& board, const SearchLimits& limits, SearchStats* stats) {
+    auto start = std::chrono::steady_clock::now();
+    if (stats) {
+        stats->reset();
+    }
     
-    std::vector<int> validMoves = getValidMoves(board);
+    // Book positions need no search at all
+    int bookMove;
+    if (this->probeOpeningBook(board, bookMove)) {
+        mainWorker.nodeCount = 0;
+        for (std::unique_ptr<SearchWorker>& helper : helperWorkers) {
+            helper->nodeCount = 0;
+        }
+        if (stats) {
+            stats->principalVariation.push_back(bookMove);
+            stats->elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+        return bookMove;
+    }
+    
+    MoveList& validMoves = mainWorker.rootMoves;
+    getValidMoves(board, validMoves);
     
     if (validMoves.empty()) {
         return -1; // No valid moves
     }
     
+    int maxDepth = limits.maxDepth > 0 ? limits.maxDepth : depth;
+    int emptyCells = BoardT::ROWS * BoardT::COLS - board.getMoveCount();
+    maxDepth = std::max(1, std::min(maxDepth, emptyCells));
+    
+    nodeLimit = limits.maxNodes;
+    hasDeadline = limits.timeMs > 0;
+    externalStop = limits.stop;
+    stopAll.store(false, std::memory_order_relaxed);
+    mainWorker.enforcesLimits = true;
+    mainWorker.deadline = start + std::chrono::milliseconds(limits.timeMs);
+    
+    HelperTask task;
+    task.boards = &board;
+    task.maxDepth = maxDepth;
+    task.helpers = helperWorkers.size();
+    startHelpers(task);
+    
+    // Only the main thread collects statistics, so helpers never pay for them
+    mainWorker.stats = stats;
+    int bestMove = iterativeDeepening(mainWorker, board, validMoves, 1, maxDepth);
+    mainWorker.stats = nullptr;
+    
+    stopAll.store(true, std::memory_order_relaxed);
+    waitForHelpers();
+    
+    if (stats) {
+        stats->nodes = getNodeCount();
+        stats->elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        principalVariation(board, bestMove, stats->depthReached, stats->principalVariation);
+    }
+    
+    return bestMove;
+}
+
+template <typename BoardT>
+void BasicMinimaxAI<BoardT>::selectMoves(const BoardT* boards, int* moves, std::size_t count,
+                                         const SearchLimits& limits) {
+    nodeLimit = limits.maxNodes;
+    hasDeadline = limits.timeMs > 0;
+    externalStop = limits.stop;
+    stopAll.store(false, std::memory_order_relaxed);
+    
+    HelperTask task;
+    task.boards = boards;
+    task.moves = moves;
+    task.count = count;
+    task.limits = &limits;
+    task.helpers = count > 1 ? std::min(helperWorkers.size(), count - 1) : 0;
+    nextPosition.store(0, std::memory_order_relaxed);
+    for (std::size_t i = task.helpers; i < helperWorkers.size(); i++) {
+        helperWorkers[i]->nodeCount = 0;
+    }
+    
+    startHelpers(task);
+    searchBatch(mainWorker, task);
+    waitForHelpers();
+}
+
+template <typename BoardT>
+void BasicMinimaxAI<BoardT>::searchBatch(SearchWorker& worker, const HelperTask& task) {
+    // Workers claim positions one at a time, so a few slow positions
+    // don't hold up the rest of the batch
+    std::uint64_t batchNodes = 0;
+    worker.enforcesLimits = true;
+    for (std::size_t i = nextPosition++; i < task.count; i = nextPosition++) {
+        task.moves[i] = searchPosition(worker, task.boards[i], *task.limits);
+        batchNodes += worker.nodeCount;
+    }
+    worker.nodeCount = batchNodes;
+}
+
+template <typename BoardT>
+void BasicMinimaxAI<BoardT>::helperLoop(std::size_t index) {
+    SearchWorker& worker = *helperWorkers[index];
+    std::uint64_t seenGeneration = 0;
+    while (true) {
+        HelperTask task;
+        {
+            std::unique_lock<std::mutex> lock(helperMutex);
+            helperWake.wait(lock, [this, seenGeneration]() {
+                return helpersShutdown || helperGeneration != seenGeneration;
+            });
+            if (helpersShutdown) {
+                return;
+            }
+            seenGeneration = helperGeneration;
+            task = helperTask;
+        }
+        if (index >= task.helpers) {
+            continue;
+        }
+        
+        if (task.moves) {
+            searchBatch(worker, task);
+        } else {
+            // Helpers start at alternating depths with rotated root moves so they
+            // explore different parts of the tree and fill the table for the main thread
+            MoveList& rootMoves = worker.rootMoves;
+            getValidMoves(*task.boards, rootMoves);
+            std::rotate(rootMoves.begin(), rootMoves.begin() + (index + 1) % rootMoves.count, rootMoves.end());
+            worker.enforcesLimits = false;
+            iterativeDeepening(worker, *task.boards, rootMoves, 1 + static_cast<int>(index % 2), task.maxDepth);
+        }
+        
+        std::lock_guard<std::mutex> lock(helperMutex);
+        if (--helpersRunning == 0) {
+            helperIdle.notify_all();
+        }
+    }
+}
+
+template <typename BoardT>
+void BasicMinimaxAI<BoardT>::startHelpers(const HelperTask& task) {
+    if (task.helpers == 0) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(helperMutex);
+        helperTask = task;
+        helpersRunning = task.helpers;
+        helperGeneration++;
+    }
+    helperWake.notify_all();
+}
+
+template <typename BoardT>
+void BasicMinimaxAI<BoardT>::waitForHelpers() {
+    std::unique_lock<std::mutex> lock(helperMutex);
+    helperIdle.wait(lock, [this]() { return helpersRunning == 0; });
+}
+
+template <typename BoardT>
+int BasicMinimaxAI<BoardT>::searchPosition(SearchWorker& worker, const BoardT& board, const SearchLimits& limits) {
+    int bookMove;
+    if (this->probeOpeningBook(board, bookMove)) {
+        worker.nodeCount = 0;
+        return bookMove;
+    }
+    
+    getValidMoves(board, worker.rootMoves);
+    if (worker.rootMoves.empty()) {
+        worker.nodeCount = 0;
+        return -1;
+    }
+    
+    int maxDepth = limits.maxDepth > 0 ? limits.maxDepth : depth;
+    int emptyCells = BoardT::ROWS * BoardT::COLS - board.getMoveCount();
+    maxDepth = std::max(1, std::min(maxDepth, emptyCells));
+    
+    worker.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(limits.timeMs);
+    return iterativeDeepening(worker, board, worker.rootMoves, 1, maxDepth);
+}
+
+template <typename BoardT>
+std::uint64_t BasicMinimaxAI<BoardT>::getNodeCount() const {
+    std::uint64_t total = mainWorker.nodeCount;
+    for (const std::unique_ptr<SearchWorker>& helper : helperWorkers) {
+        total += helper->nodeCount;
+    }
+    return total;
+}
+
+template <typename BoardT>
+void BasicMinimaxAI<BoardT>::setMoveOrdering(bool enabled) {
+    moveOrdering = enabled;
+}
+
+template <typename BoardT>
+void BasicMinimaxAI<BoardT>::clearTranspositionTable() {
+    transpositionTable.clear();
+}
+
+template <typename BoardT>
+void BasicMinimaxAI<BoardT>::newGame(std::uint32_t seed) {
+    (void)seed;
+    transpositionTable.clear();
+}
+
+template <typename BoardT>
+int BasicMinimaxAI<BoardT>::iterativeDeepening(SearchWorker& worker, const BoardT& board, MoveList& rootMoves,
+                                  int firstDepth, int maxDepth) {
+    // Search on the worker's own copy, applying and reverting moves in place
+    worker.board = board;
+    worker.evaluator.reset(board, aiPlayer);
+    worker.nodeCount = 0;
+    worker.limitsActive = false;
+    worker.stopped = false;
+    std::fill(&worker.killerMoves[0][0], &worker.killerMoves[0][0] + (MAX_PLY + 1) * 2, -1);
+    std::fill(&worker.historyScores[0][0], &worker.historyScores[0][0] + 2 * BoardT::ROWS * BoardT::COLS, 0);
+    
+    int bestMove = rootMoves[0];
+    
+    // Iterative deepening: each completed iteration replaces the answer
+    for (int searchDepth = firstDepth; searchDepth <= maxDepth; searchDepth++) {
+        int score;
+        int move = worker.stats ? searchRoot<true>(worker, searchDepth, rootMoves, score)
+                                : searchRoot<false>(worker, searchDepth, rootMoves, score);
+        if (move < 0) {
+            break;
+        }
+        bestMove = move;
+        if (worker.stats) {
+            worker.stats->depthReached = searchDepth;
+            worker.stats->score = score;
+        }
+        
+        // Search the previous iteration's best move first next time
+        if (moveOrdering) {
+            auto it = std::find(rootMoves.begin(), rootMoves.end(), bestMove);
+            std::rotate(rootMoves.begin(), it, it + 1);
+        }
+        
+        // A forced win or loss won't change with more depth
+        if (score > WIN_THRESHOLD || score < -WIN_THRESHOLD) {
+            break;
+        }
+        
+        // Budgets only apply once there is a complete answer to fall back on
+        if (worker.enforcesLimits) {
+            worker.limitsActive = true;
+            if ((nodeLimit > 0 && worker.nodeCount >= nodeLimit) ||
+                (hasDeadline && std::chrono::steady_clock::now() >= worker.deadline)) {
+                break;
+            }
+        }
+    }
+    
+    return bestMove;
+}
+
+template <typename BoardT>
+template <bool CollectStats>
+int BasicMinimaxAI<BoardT>::searchRoot(SearchWorker& worker, int searchDepth, const MoveList& validMoves, int& bestScore) {
+    worker.iterationDepth = searchDepth;
     int bestMove = validMoves[0];
-    int bestScore = std::numeric_limits<int>::min();
+    bestScore = std::numeric_limits<int>::min();
     
     // Try each valid move and find the one with the best score
     for (int col : validMoves) {
-        Board simBoard = board;
-        if (simBoard.dropPiece(col, aiPlayer)) {
-            // Use minimax to evaluate this move
-            int score = minimax(simBoard, depth - 1, 
-                               std::numeric_limits<int>::min(), 
+        typename BoardT::MoveGuard move(worker.board, col, aiPlayer);
+        if (move.applied()) {
+            typename Evaluator::MoveGuard evalMove(worker.evaluator, col, worker.board.getColumnHeight(col) - 1, true);
+            // Moves that can't beat the best so far only need a bound
+            int score = minimax<CollectStats>(worker, searchDepth - 1, 
+                               bestScore, 
                                std::numeric_limits<int>::max(), 
                                false);
+            if (worker.stopped) {
+                return -1;
+            }
             
             if (score > bestScore) {
                 bestScore = score;
@@ -40,118 +491,292 @@ int MinimaxAI::selectMove(const Board& board) {
     return bestMove;
 }
 
-int MinimaxAI::minimax(Board& board, int currentDepth, int alpha, int beta, bool isMaximizing) {
-    // Terminal conditions
-    if (board.checkWin(aiPlayer)) {
-        return 1000000 + currentDepth; // Prefer faster wins
+template <typename BoardT>
+bool BasicMinimaxAI<BoardT>::checkLimits(SearchWorker& worker) {
+    if (stopAll.load(std::memory_order_relaxed) ||
+        (externalStop && externalStop->load(std::memory_order_relaxed))) {
+        worker.stopped = true;
+    } else if (!worker.limitsActive) {
+        return false;
+    } else if (nodeLimit > 0 && worker.nodeCount >= nodeLimit) {
+        worker.stopped = true;
+    } else if (hasDeadline && (worker.nodeCount & 1023) == 0 &&
+               std::chrono::steady_clock::now() >= worker.deadline) {
+        // Reading the clock is comparatively slow, so only do it periodically
+        worker.stopped = true;
     }
-    if (board.checkWin(humanPlayer)) {
-        return -1000000 - currentDepth; // Prefer slower losses
+    return worker.stopped;
+}
+
+template <typename BoardT>
+template <bool CollectStats>
+int BasicMinimaxAI<BoardT>::minimax(SearchWorker& worker, int currentDepth, int alpha, int beta, bool isMaximizing) {
+    worker.nodeCount++;
+    if (checkLimits(worker)) {
+        return 0;
+    }
+    
+    BoardT& board = worker.board;
+    
+    // Terminal conditions: only the move that led here can have won,
+    // and it was made by the player who is not to move now
+    if (board.lastMoveWins()) {
+        if (isMaximizing) {
+            return -1000000 - currentDepth; // Prefer slower losses
+        }
+        return 1000000 + currentDepth; // Prefer faster wins
     }
     if (board.isFull() || currentDepth == 0) {
-        return evaluateBoard(board);
+        if constexpr (CollectStats) {
+            worker.stats->leafEvaluations++;
+        }
+        return worker.evaluator.score();
     }
     
-    std::vector<int> validMoves = getValidMoves(board);
+    // Reuse results from earlier visits of this position
+    std::uint64_t key = tableKey(board, isMaximizing);
+    TranspositionTable::Entry entry;
+    int ttMove = -1;
+    bool ttHit = transpositionTable.probe(key, entry);
+    if constexpr (CollectStats) {
+        worker.stats->ttProbes++;
+        worker.stats->ttHits += ttHit ? 1 : 0;
+    }
+    if (ttHit) {
+        // Even a too-shallow entry knows a good move to try first
+        ttMove = entry.bestMove;
+    }
+    if (ttHit && entry.depth >= currentDepth) {
+        int cached = scoreFromTable(entry.score, currentDepth);
+        if (entry.bound == TranspositionTable::Bound::EXACT) {
+            if constexpr (CollectStats) {
+                worker.stats->ttCutoffs++;
+            }
+            return cached;
+        } else if (entry.bound == TranspositionTable::Bound::LOWER) {
+            alpha = std::max(alpha, cached);
+        } else {
+            beta = std::min(beta, cached);
+        }
+        if (beta <= alpha) {
+            if constexpr (CollectStats) {
+                worker.stats->ttCutoffs++;
+            }
+            return cached;
+        }
+    }
+    
+    int originalAlpha = alpha;
+    int originalBeta = beta;
+    int bestMove = -1;
+    int bestScore;
+    int cutoffMove = -1;
+    int ply = worker.iterationDepth - currentDepth;
+    
+    MoveList validMoves;
+    orderMoves(worker, ply, ttMove, isMaximizing, validMoves);
     
     if (isMaximizing) {
         int maxScore = std::numeric_limits<int>::min();
         
         for (int col : validMoves) {
-            Board simBoard = board;
-            if (simBoard.dropPiece(col, aiPlayer)) {
-                int score = minimax(simBoard, currentDepth - 1, alpha, beta, false);
-                maxScore = std::max(maxScore, score);
+            typename BoardT::MoveGuard move(board, col, aiPlayer);
+            if (move.applied()) {
+                typename Evaluator::MoveGuard evalMove(worker.evaluator, col, board.getColumnHeight(col) - 1, true);
+                int score = minimax<CollectStats>(worker, currentDepth - 1, alpha, beta, false);
+                if (worker.stopped) {
+                    return 0;
+                }
+                if (score > maxScore) {
+                    maxScore = score;
+                    bestMove = col;
+                }
                 alpha = std::max(alpha, score);
                 
                 // Alpha-beta pruning
                 if (beta <= alpha) {
+                    cutoffMove = col;
                     break;
                 }
             }
         }
         
-        return maxScore;
+        bestScore = maxScore;
     } else {
         int minScore = std::numeric_limits<int>::max();
         
         for (int col : validMoves) {
-            Board simBoard = board;
-            if (simBoard.dropPiece(col, humanPlayer)) {
-                int score = minimax(simBoard, currentDepth - 1, alpha, beta, true);
-                minScore = std::min(minScore, score);
+            typename BoardT::MoveGuard move(board, col, humanPlayer);
+            if (move.applied()) {
+                typename Evaluator::MoveGuard evalMove(worker.evaluator, col, board.getColumnHeight(col) - 1, false);
+                int score = minimax<CollectStats>(worker, currentDepth - 1, alpha, beta, true);
+                if (worker.stopped) {
+                    return 0;
+                }
+                if (score < minScore) {
+                    minScore = score;
+                    bestMove = col;
+                }
                 beta = std::min(beta, score);
                 
                 // Alpha-beta pruning
                 if (beta <= alpha) {
+                    cutoffMove = col;
                     break;
                 }
             }
         }
         
-        return minScore;
+        bestScore = minScore;
+    }
+    
+    if constexpr (CollectStats) {
+        if (cutoffMove >= 0) {
+            worker.stats->cutoffs++;
+            worker.stats->cutoffsPerPly[ply]++;
+        }
+    }
+    if (cutoffMove >= 0 && moveOrdering) {
+        recordCutoff(worker, ply, cutoffMove, currentDepth, isMaximizing);
+    }
+    
+    // A score outside the original window is only a bound on the true value
+    TranspositionTable::Bound bound = TranspositionTable::Bound::EXACT;
+    if (bestScore <= originalAlpha) {
+        bound = TranspositionTable::Bound::UPPER;
+    } else if (bestScore >= originalBeta) {
+        bound = TranspositionTable::Bound::LOWER;
     }
+    transpositionTable.store(key, scoreToTable(bestScore, currentDepth), currentDepth, bound, bestMove);
+    
+    return bestScore;
 }
 
-int MinimaxAI::evaluateBoard(const Board& board) {
+template <typename BoardT>
+void BasicMinimaxAI<BoardT>::principalVariation(const BoardT& board, int bestMove, int length,
+                                                std::vector<int>& line) {
+    line.clear();
+    BoardT position = board;
+    char player = aiPlayer;
+    int move = bestMove;
+    
+    // Follow the best moves stored in the table from the root on
+    while (move >= 0 && static_cast<int>(line.size()) < length) {
+        if (!position.dropPiece(move, player)) {
+            break;
+        }
+        line.push_back(move);
+        if (position.lastMoveWins() || position.isFull()) {
+            break;
+        }
+        
+        player = (player == aiPlayer) ? humanPlayer : aiPlayer;
+        std::uint64_t key = tableKey(position, player == aiPlayer);
+        TranspositionTable::Entry entry;
+        move = transpositionTable.probe(key, entry) ? entry.bestMove : -1;
+    }
+}
+
+template <typename BoardT>
+int BasicMinimaxAI<BoardT>::evaluateBoard(const BoardT& board) {
+    using Bitboard = typename BoardT::Bitboard;
+    const int K = BoardT::CONNECT;
+    const WindowTable<BoardT>& windows = WINDOWS<BoardT>;
+    Bitboard ai = board.getPlayerMask(aiPlayer);
+    Bitboard human = board.getPlayerMask(humanPlayer);
     int score = 0;
     
+    // Evaluates all windows of one direction at once: bit p of each mask
+    // below describes the window whose first cell is bit p
+    for (int dir = 0; dir < 4; dir++) {
+        int shift = windowShift<BoardT>(dir);
+        
+        // Cell i of every window, and the cells either side has in it
+        Bitboard a[K];
+        Bitboard h[K];
+        Bitboard aiAny = 0;
+        Bitboard humanAny = 0;
+        for (int i = 0; i < K; i++) {
+            a[i] = ai >> (i * shift);
+            h[i] = human >> (i * shift);
+            aiAny |= a[i];
+            humanAny |= h[i];
+        }
+        
+        // Windows without any opponent piece, from each side's point of view
+        Bitboard aiOnly = windows.starts[dir] & ~humanAny;
+        Bitboard humanOnly = windows.starts[dir] & ~aiAny;
+        
+        WindowCounts<Bitboard> aiCounts = countWindows<K>(a);
+        WindowCounts<Bitboard> humanCounts = countWindows<K>(h);
+        
+        // Same scores as evaluateWindow; a window with fewer than K
+        // pieces always has an empty cell
+        score += 1000 * popcount(aiOnly & aiCounts.full);
+        score += 100 * popcount(aiOnly & aiCounts.oneShort);
+        score -= 80 * popcount(humanOnly & humanCounts.oneShort);
+        if constexpr (K > 2) {
+            score += 10 * popcount(aiOnly & aiCounts.twoShort);
+            score -= 10 * popcount(humanOnly & humanCounts.twoShort);
+        }
+    }
+    
+    // Center column preference
+    score += popcount(ai & windows.centerColumn) * 3;
+    
+    return score;
+}
+
+template <typename BoardT>
+int BasicMinimaxAI<BoardT>::evaluateBoardReference(const BoardT& board) {
+    const int K = BoardT::CONNECT;
+    int score = 0;
+    char window[K];
+    
     // Check all horizontal windows
-    for (int row = 0; row < Board::ROWS; row++) {
-        for (int col = 0; col <= Board::COLS - 4; col++) {
-            char window[4] = {
-                board.getCell(row, col),
-                board.getCell(row, col + 1),
-                board.getCell(row, col + 2),
-                board.getCell(row, col + 3)
-            };
+    for (int row = 0; row < BoardT::ROWS; row++) {
+        for (int col = 0; col <= BoardT::COLS - K; col++) {
+            for (int i = 0; i < K; i++) {
+                window[i] = board.getCell(row, col + i);
+            }
             score += evaluateWindow(window);
         }
     }
     
     // Check all vertical windows
-    for (int col = 0; col < Board::COLS; col++) {
-        for (int row = 0; row <= Board::ROWS - 4; row++) {
-            char window[4] = {
-                board.getCell(row, col),
-                board.getCell(row + 1, col),
-                board.getCell(row + 2, col),
-                board.getCell(row + 3, col)
-            };
+    for (int col = 0; col < BoardT::COLS; col++) {
+        for (int row = 0; row <= BoardT::ROWS - K; row++) {
+            for (int i = 0; i < K; i++) {
+                window[i] = board.getCell(row + i, col);
+            }
             score += evaluateWindow(window);
         }
     }
     
     // Check all diagonal windows (positive slope)
-    for (int row = 0; row <= Board::ROWS - 4; row++) {
-        for (int col = 0; col <= Board::COLS - 4; col++) {
-            char window[4] = {
-                board.getCell(row, col),
-                board.getCell(row + 1, col + 1),
-                board.getCell(row + 2, col + 2),
-                board.getCell(row + 3, col + 3)
-            };
+    for (int row = 0; row <= BoardT::ROWS - K; row++) {
+        for (int col = 0; col <= BoardT::COLS - K; col++) {
+            for (int i = 0; i < K; i++) {
+                window[i] = board.getCell(row + i, col + i);
+            }
             score += evaluateWindow(window);
         }
     }
     
     // Check all diagonal windows (negative slope)
-    for (int row = 3; row < Board::ROWS; row++) {
-        for (int col = 0; col <= Board::COLS - 4; col++) {
-            char window[4] = {
-                board.getCell(row, col),
-                board.getCell(row - 1, col + 1),
-                board.getCell(row - 2, col + 2),
-                board.getCell(row - 3, col + 3)
-            };
+    for (int row = K - 1; row < BoardT::ROWS; row++) {
+        for (int col = 0; col <= BoardT::COLS - K; col++) {
+            for (int i = 0; i < K; i++) {
+                window[i] = board.getCell(row - i, col + i);
+            }
             score += evaluateWindow(window);
         }
     }
     
     // Center column preference
-    int centerCol = Board::COLS / 2;
+    int centerCol = BoardT::COLS / 2;
     int centerCount = 0;
-    for (int row = 0; row < Board::ROWS; row++) {
+    for (int row = 0; row < BoardT::ROWS; row++) {
         if (board.getCell(row, centerCol) == aiPlayer) {
             centerCount++;
         }
@@ -161,7 +786,9 @@ int MinimaxAI::evaluateBoard(const Board& board) {
     return score;
 }
 
-int MinimaxAI::evaluateWindow(const char window[4]) {
+template <typename BoardT>
+int BasicMinimaxAI<BoardT>::evaluateWindow(const char window[BoardT::CONNECT]) {
+    const int K = BoardT::CONNECT;
     int aiCount = countPieces(window, aiPlayer);
     int humanCount = countPieces(window, humanPlayer);
     bool empty = hasEmpty(window);
@@ -172,39 +799,95 @@ int MinimaxAI::evaluateWindow(const char window[4]) {
     }
     
     // Score based on AI pieces in window
-    if (aiCount == 4) {
-        return 1000; // Four in a row (shouldn't happen if game checks win)
-    } else if (aiCount == 3 && empty) {
-        return 100; // Three with potential to make four
-    } else if (aiCount == 2 && empty) {
-        return 10; // Two with potential to make four
+    if (aiCount == K) {
+        return 1000; // K in a row (shouldn't happen if game checks win)
+    } else if (aiCount > 0 && aiCount == K - 1 && empty) {
+        return 100; // One short of a line, with room to complete it
+    } else if (aiCount > 0 && aiCount == K - 2 && empty) {
+        return 10; // Two short of a line
     }
     
     // Penalize opponent pieces in window
-    if (humanCount == 3 && empty) {
-        return -80; // Block opponent's three in a row
-    } else if (humanCount == 2 && empty) {
+    if (humanCount > 0 && humanCount == K - 1 && empty) {
+        return -80; // Block opponent's near-complete line
+    } else if (humanCount > 0 && humanCount == K - 2 && empty) {
         return -10;
     }
     
     return 0;
 }
 
-std::vector<int> MinimaxAI::getValidMoves(const Board& board) {
-    std::vector<int> validMoves;
-    
-    for (int col = 0; col < Board::COLS; col++) {
+template <typename BoardT>
+void BasicMinimaxAI<BoardT>::getValidMoves(const BoardT& board, MoveList& validMoves) {
+    validMoves.count = 0;
+    for (int i = 0; i < BoardT::COLS; i++) {
+        int col = moveOrdering ? BoardT::centerOutColumn(i) : i;
         if (!board.isColumnFull(col)) {
-            validMoves.push_back(col);
+            validMoves.push(col);
+        }
+    }
+}
+
+template <typename BoardT>
+void BasicMinimaxAI<BoardT>::orderMoves(const SearchWorker& worker, int ply, int ttMove, bool isMaximizing,
+                                        MoveList& validMoves) {
+    const BoardT& board = worker.board;
+    getValidMoves(board, validMoves);
+    if (!moveOrdering) {
+        return;
+    }
+    
+    const int* killers = worker.killerMoves[ply];
+    const int* history = worker.historyScores[isMaximizing ? 0 : 1];
+    
+    int* moves = validMoves.moves;
+    int priorities[BoardT::COLS];
+    for (int i = 0; i < validMoves.count; i++) {
+        int col = moves[i];
+        if (col == ttMove) {
+            priorities[i] = TT_MOVE_PRIORITY;
+        } else if (col == killers[0]) {
+            priorities[i] = KILLER_PRIORITY + 1;
+        } else if (col == killers[1]) {
+            priorities[i] = KILLER_PRIORITY;
+        } else {
+            priorities[i] = history[col * BoardT::ROWS + board.getColumnHeight(col)];
+        }
+    }
+    
+    // Stable insertion sort: at most one move per column, and equal priorities
+    // keep their center-out order
+    for (int i = 1; i < validMoves.count; i++) {
+        int col = moves[i];
+        int priority = priorities[i];
+        int j = i;
+        while (j > 0 && priorities[j - 1] < priority) {
+            moves[j] = moves[j - 1];
+            priorities[j] = priorities[j - 1];
+            j--;
         }
+        moves[j] = col;
+        priorities[j] = priority;
+    }
+}
+
+template <typename BoardT>
+void BasicMinimaxAI<BoardT>::recordCutoff(SearchWorker& worker, int ply, int col, int currentDepth, bool isMaximizing) {
+    int* killers = worker.killerMoves[ply];
+    if (killers[0] != col) {
+        killers[1] = killers[0];
+        killers[0] = col;
     }
     
-    return validMoves;
+    // Cutoffs found with more depth remaining say more about the move
+    int& history = worker.historyScores[isMaximizing ? 0 : 1][col * BoardT::ROWS + worker.board.getColumnHeight(col)];
+    history = std::min(history + currentDepth * currentDepth, HISTORY_MAX);
 }
 
-int MinimaxAI::countPieces(const char window[4], char player) {
+template <typename BoardT>
+int BasicMinimaxAI<BoardT>::countPieces(const char window[BoardT::CONNECT], char player) {
     int count = 0;
-    for (int i = 0; i < 4; i++) {
+    for (int i = 0; i < BoardT::CONNECT; i++) {
         if (window[i] == player) {
             count++;
         }
@@ -212,11 +895,18 @@ int MinimaxAI::countPieces(const char window[4], char player) {
     return count;
 }
 
-bool MinimaxAI::hasEmpty(const char window[4]) {
-    for (int i = 0; i < 4; i++) {
+template <typename BoardT>
+bool BasicMinimaxAI<BoardT>::hasEmpty(const char window[BoardT::CONNECT]) {
+    for (int i = 0; i < BoardT::CONNECT; i++) {
         if (window[i] == ' ') {
             return true;
         }
     }
     return false;
 }
+
+// The variants aliased in Board.h
+template class BasicMinimaxAI<Board>;
+template class BasicMinimaxAI<Board8x7>;
+template class BasicMinimaxAI<Board9x7>;
+template class BasicMinimaxAI<Board9x6Connect5>;
@@ -0,0 +1,152 @@
+#include "OpeningBook.h"
+#include "BitUtils.h"
+#include <algorithm>
+#include <fstream>
+
+namespace {
+
+const unsigned char MAGIC[4] = {'C', '4', 'B', 'K'};
+const std::size_t HEADER_SIZE = 16;
+const std::size_t ENTRY_SIZE = 8;
+
+// Entry word layout, from the low bits up
+const int SCORE_BITS = 6;
+const int SCORE_OFFSET = 32;
+const int MOVE_SHIFT = SCORE_BITS;
+const int KEY_SHIFT = 15;
+
+std::uint64_t packEntry(const OpeningBook::Entry& entry) {
+    return entry.key << KEY_SHIFT |
+           static_cast<std::uint64_t>(entry.move) << MOVE_SHIFT |
+           static_cast<std::uint64_t>(entry.score + SCORE_OFFSET);
+}
+
+} // namespace
+
+OpeningBook::OpeningBook() : entryCount(0), plies(0) {}
+
+bool OpeningBook::open(const std::string& path) {
+    close();
+    if (!file.open(path)) {
+        return false;
+    }
+
+    const unsigned char* header = file.data();
+    bool valid = file.size() >= HEADER_SIZE &&
+                 std::equal(MAGIC, MAGIC + 4, header) &&
+                 header[4] == FORMAT_VERSION &&
+                 header[5] == Board::ROWS &&
+                 header[6] == Board::COLS;
+    std::uint64_t count = valid ? readLittleEndian64(header + 8) : 0;
+    if (!valid || count != (file.size() - HEADER_SIZE) / ENTRY_SIZE) {
+        close();
+        return false;
+    }
+
+    entryCount = static_cast<std::size_t>(count);
+    plies = header[7];
+    return true;
+}
+
+void OpeningBook::close() {
+    file.close();
+    entryCount = 0;
+    plies = 0;
+}
+
+bool OpeningBook::isOpen() const {
+    return file.isOpen();
+}
+
+std::size_t OpeningBook::size() const {
+    return entryCount;
+}
+
+int OpeningBook::getPlies() const {
+    return plies;
+}
+
+bool OpeningBook::probe(const Board& board, int& move, int& score) const {
+    if (entryCount == 0 || board.getMoveCount() > plies) {
+        return false;
+    }
+
+    bool mirrored;
+    std::uint64_t key = canonicalKey(board, mirrored);
+
+    // Binary search for the first entry at or above the key's range
+    std::uint64_t lowest = key << KEY_SHIFT;
+    std::size_t first = 0;
+    std::size_t count = entryCount;
+    while (count > 0) {
+        std::size_t half = count / 2;
+        if (entryAt(first + half) < lowest) {
+            first += half + 1;
+            count -= half + 1;
+        } else {
+            count = half;
+        }
+    }
+
+    if (first == entryCount) {
+        return false;
+    }
+    std::uint64_t entry = entryAt(first);
+    if (entry >> KEY_SHIFT != key) {
+        return false;
+    }
+
+    int bookMove = static_cast<int>((entry >> MOVE_SHIFT) & 7);
+    move = mirrored ? Board::COLS - 1 - bookMove : bookMove;
+    score = static_cast<int>(entry & ((1 << SCORE_BITS) - 1)) - SCORE_OFFSET;
+    return true;
+}
+
+std::uint64_t OpeningBook::canonicalKey(const Board& board, bool& mirrored) {
+    // Each column owns ROWS + 1 bits of the key, so mirroring the board
+    // reverses the order of these groups
+    std::uint64_t key = board.getKey();
+    std::uint64_t mirroredKey = 0;
+    const std::uint64_t group = (std::uint64_t(1) << (Board::ROWS + 1)) - 1;
+    for (int col = 0; col < Board::COLS; col++) {
+        std::uint64_t bits = (key >> (col * (Board::ROWS + 1))) & group;
+        mirroredKey |= bits << ((Board::COLS - 1 - col) * (Board::ROWS + 1));
+    }
+
+    mirrored = mirroredKey < key;
+    return mirrored ? mirroredKey : key;
+}
+
+bool OpeningBook::write(const std::string& path, std::vector<Entry> entries, int plies) {
+    std::vector<std::uint64_t> words;
+    words.reserve(entries.size());
+    for (const Entry& entry : entries) {
+        words.push_back(packEntry(entry));
+    }
+    std::sort(words.begin(), words.end());
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        return false;
+    }
+
+    unsigned char header[HEADER_SIZE];
+    std::copy(MAGIC, MAGIC + 4, header);
+    header[4] = FORMAT_VERSION;
+    header[5] = Board::ROWS;
+    header[6] = Board::COLS;
+    header[7] = static_cast<unsigned char>(plies);
+    writeLittleEndian64(header + 8, words.size());
+    out.write(reinterpret_cast<const char*>(header), HEADER_SIZE);
+
+    for (std::uint64_t word : words) {
+        unsigned char bytes[ENTRY_SIZE];
+        writeLittleEndian64(bytes, word);
+        out.write(reinterpret_cast<const char*>(bytes), ENTRY_SIZE);
+    }
+    return static_cast<bool>(out);
+}
+
+std::uint64_t OpeningBook::entryAt(std::size_t index) const {
+    return readLittleEndian64(file.data() + HEADER_SIZE + index * ENTRY_SIZE);
+}
@@ -1,13 +1,18 @@
 #include "RandomAI.h"
 #include <vector>
 
-RandomAI::RandomAI() : gen(rd()) {}
+template <typename BoardT>
+BasicRandomAI<BoardT>::BasicRandomAI() : gen(rd()) {}
 
-int RandomAI::selectMove(const Board& board) {
+template <typename BoardT>
+BasicRandomAI<BoardT>::BasicRandomAI(std::uint32_t seed) : gen(seed) {}
+
+template <typename BoardT>
+int BasicRandomAI<BoardT>::selectMove(const BoardT& board) {
     // Build list of valid columns (not full)
     std::vector<int> validMoves;
     
-    for (int col = 0; col < Board::COLS; col++) {
+    for (int col = 0; col < BoardT::COLS; col++) {
         if (!board.isColumnFull(col)) {
             validMoves.push_back(col);
         }
@@ -25,3 +30,14 @@ int RandomAI::selectMove(const Board& board) {
     
     return validMoves[randomIndex];
 }
+
+template <typename BoardT>
+void BasicRandomAI<BoardT>::newGame(std::uint32_t seed) {
+    gen.seed(seed);
+}
+
+// The variants aliased in Board.h
+template class BasicRandomAI<Board>;
+template class BasicRandomAI<Board8x7>;
+template class BasicRandomAI<Board9x7>;
+template class BasicRandomAI<Board9x6Connect5>;
@@ -0,0 +1,53 @@
+#include "SearchStats.h"
+#include <cmath>
+#include <utility>
+
+void SearchStats::reset() {
+    std::vector<int> line = std::move(principalVariation);
+    *this = SearchStats();
+    line.clear();
+    line.reserve(MAX_PLY);
+    principalVariation = std::move(line);
+}
+
+double SearchStats::ttHitRate() const {
+    if (ttProbes == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(ttHits) / static_cast<double>(ttProbes);
+}
+
+double SearchStats::effectiveBranchingFactor() const {
+    if (depthReached <= 0 || nodes == 0) {
+        return 0.0;
+    }
+    return std::pow(static_cast<double>(nodes), 1.0 / depthReached);
+}
+
+void SearchStats::print(std::ostream& out) const {
+    double seconds = elapsedMs / 1000.0;
+    out << "depth " << depthReached << ", score " << score << ", " << elapsedMs << " ms\n";
+    out << "nodes " << nodes;
+    if (seconds > 0.0) {
+        out << " (" << static_cast<std::uint64_t>(nodes / seconds) << " nodes/s)";
+    }
+    out << ", leaf evaluations " << leafEvaluations
+        << ", branching factor " << effectiveBranchingFactor() << "\n";
+    out << "tt probes " << ttProbes << ", hit rate " << 100.0 * ttHitRate()
+        << "%, tt cutoffs " << ttCutoffs << "\n";
+
+    out << "cutoffs " << cutoffs;
+    for (int ply = 0; ply <= MAX_PLY; ply++) {
+        if (cutoffsPerPly[ply] > 0) {
+            out << " [" << ply << "] " << cutoffsPerPly[ply];
+        }
+    }
+    out << "\n";
+
+    // Columns are shown 1-based, as players enter them
+    out << "pv";
+    for (int move : principalVariation) {
+        out << " " << move + 1;
+    }
+    out << "\n";
+}
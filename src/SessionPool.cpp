@@ -0,0 +1,69 @@
+#include "SessionPool.h"
+
+SessionPool::SessionPool(std::size_t capacity)
+    : maxSessions(capacity < SessionHandle::INVALID_INDEX ? capacity : SessionHandle::INVALID_INDEX - 1),
+      slotCount(0), openSessions(0), freeHead(SessionHandle::INVALID_INDEX) {}
+
+SessionHandle SessionPool::allocate() {
+    std::uint32_t index;
+    if (freeHead != SessionHandle::INVALID_INDEX) {
+        index = freeHead;
+        freeHead = slotAt(index)->nextFree;
+    } else if (slotCount < maxSessions) {
+        if (slotCount % SLAB_SIZE == 0) {
+            slabs.push_back(std::make_unique<Slot[]>(SLAB_SIZE));
+        }
+        index = static_cast<std::uint32_t>(slotCount++);
+    } else {
+        return SessionHandle();
+    }
+
+    Slot* slot = slotAt(index);
+    slot->session = GameSession();
+    slot->inUse = true;
+    openSessions++;
+
+    SessionHandle handle;
+    handle.index = index;
+    handle.generation = slot->generation;
+    return handle;
+}
+
+bool SessionPool::release(SessionHandle handle) {
+    if (!get(handle)) {
+        return false;
+    }
+
+    // Bumping the generation invalidates every outstanding handle
+    Slot* slot = slotAt(handle.index);
+    slot->inUse = false;
+    slot->generation++;
+    slot->nextFree = freeHead;
+    freeHead = handle.index;
+    openSessions--;
+    return true;
+}
+
+GameSession* SessionPool::get(SessionHandle handle) {
+    if (handle.index >= slotCount) {
+        return nullptr;
+    }
+    Slot* slot = slotAt(handle.index);
+    return (slot->inUse && slot->generation == handle.generation) ? &slot->session : nullptr;
+}
+
+const GameSession* SessionPool::get(SessionHandle handle) const {
+    return const_cast<SessionPool*>(this)->get(handle);
+}
+
+std::size_t SessionPool::size() const {
+    return openSessions;
+}
+
+std::size_t SessionPool::capacity() const {
+    return maxSessions;
+}
+
+SessionPool::Slot* SessionPool::slotAt(std::uint32_t index) const {
+    return &slabs[index / SLAB_SIZE][index % SLAB_SIZE];
+}
@@ -0,0 +1,432 @@
+#include "SolverAI.h"
+#include <algorithm>
+#include <type_traits>
+
+namespace {
+
+/**
+ * Bitboard helpers for one board variant, on the same column-major layout
+ * as Board: HEIGHT playable bits per column plus a clear sentinel bit on top
+ */
+template <typename BoardT>
+struct SolverBits {
+    using Bitboard = typename BoardT::Bitboard;
+
+    static constexpr int WIDTH = BoardT::COLS;
+    static constexpr int HEIGHT = BoardT::ROWS;
+    static constexpr int CELLS = WIDTH * HEIGHT;
+    static constexpr int K = BoardT::CONNECT;
+
+    static constexpr Bitboard BOTTOM_MASK = BoardT::bottomMask();
+    static constexpr Bitboard BOARD_MASK = BoardT::boardMask();
+
+    static Bitboard columnMask(int col) {
+        return BoardT::columnMask(col);
+    }
+
+    /**
+     * Empty cells that would complete a line of K for the given stones
+     */
+    static Bitboard winningCells(Bitboard position, Bitboard mask) {
+        const int shifts[3] = {HEIGHT + 1, HEIGHT, HEIGHT + 2};
+        Bitboard result = 0;
+
+        if constexpr (K == 4) {
+            // Vertical: three stones directly below
+            result = (position << 1) & (position << 2) & (position << 3);
+
+            // Horizontal and both diagonals: the cell can be at any of the four
+            // places in the line, so look for the other three on either side
+            for (int shift : shifts) {
+                Bitboard pair = (position << shift) & (position << (2 * shift));
+                result |= pair & (position << (3 * shift));
+                result |= pair & (position >> shift);
+                pair = (position >> shift) & (position >> (2 * shift));
+                result |= pair & (position << shift);
+                result |= pair & (position >> (3 * shift));
+            }
+        } else {
+            // Vertical: K - 1 stones directly below
+            result = ~Bitboard(0);
+            for (int d = 1; d < K; d++) {
+                result &= position << d;
+            }
+
+            // Horizontal and both diagonals: try the cell at each place in
+            // the line, with stones on the other K - 1
+            for (int shift : shifts) {
+                for (int place = 0; place < K; place++) {
+                    Bitboard line = ~Bitboard(0);
+                    for (int j = 0; j < K; j++) {
+                        if (j < place) {
+                            line &= position << ((place - j) * shift);
+                        } else if (j > place) {
+                            line &= position >> ((j - place) * shift);
+                        }
+                    }
+                    result |= line;
+                }
+            }
+        }
+
+        return result & (BOARD_MASK ^ mask);
+    }
+
+    static Bitboard playableCells(Bitboard mask) {
+        return (mask + BOTTOM_MASK) & BOARD_MASK;
+    }
+
+    /**
+     * Playable cells that don't hand the opponent an immediate win
+     * @return 0 if every move loses at once
+     */
+    static Bitboard nonLosingMoves(Bitboard current, Bitboard mask) {
+        Bitboard possible = playableCells(mask);
+        Bitboard opponentWins = winningCells(current ^ mask, mask);
+        Bitboard forced = possible & opponentWins;
+
+        if (forced) {
+            // Two threats can't both be blocked
+            if (forced & (forced - Bitboard(1))) {
+                return 0;
+            }
+            possible = forced;
+        }
+
+        // Never play directly below a cell where the opponent would win
+        return possible & ~(opponentWins >> 1);
+    }
+
+    static bool canWinNext(Bitboard current, Bitboard mask) {
+        return static_cast<bool>(winningCells(current, mask) & playableCells(mask));
+    }
+
+    /**
+     * Transposition table key shared by a position and its mirror image, which
+     * always have the same score. Each column's stones plus its height marker
+     * occupy their own HEIGHT + 1 bits, so mirroring just reverses the groups.
+     * Keys wider than 64 bits are hashed down, so they may collide.
+     */
+    static std::uint64_t positionKey(Bitboard current, Bitboard mask) {
+        Bitboard key = current + mask + BOTTOM_MASK;
+        Bitboard mirrored = 0;
+        const Bitboard group = (Bitboard(1) << (HEIGHT + 1)) - Bitboard(1);
+        for (int col = 0; col < WIDTH; col++) {
+            Bitboard bits = (key >> (col * (HEIGHT + 1))) & group;
+            mirrored |= bits << ((WIDTH - 1 - col) * (HEIGHT + 1));
+        }
+
+        Bitboard canonical = key < mirrored ? key : mirrored;
+        if constexpr (std::is_same<Bitboard, std::uint64_t>::value) {
+            return canonical;
+        } else {
+            return hashKey(canonical);
+        }
+    }
+};
+
+} // namespace
+
+template <typename BoardT>
+BasicSolverAI<BoardT>::BasicSolverAI(std::size_t ttSizeMB)
+    : transpositionTable(ttSizeMB), nodeCount(0), stopRequest(nullptr), nodeLimit(0), hasDeadline(false),
+      stopped(false) {}
+
+template <typename BoardT>
+int BasicSolverAI<BoardT>::selectMove(const BoardT& board) {
+    int bookMove;
+    if (this->probeOpeningBook(board, bookMove)) {
+        return bookMove;
+    }
+    return solveMove(board);
+}
+
+template <typename BoardT>
+int BasicSolverAI<BoardT>::selectMove(const BoardT& board, const SearchLimits& limits) {
+    using Bits = SolverBits<BoardT>;
+    int bookMove;
+    if (this->probeOpeningBook(board, bookMove)) {
+        return bookMove;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    int emptyCells = Bits::CELLS - board.getMoveCount();
+    std::uint64_t nodesBefore = nodeCount;
+    if (limits.maxDepth <= 0 || emptyCells <= limits.maxDepth) {
+        stopRequest = limits.stop;
+        nodeLimit = limits.maxNodes > 0 ? nodeCount + std::max<std::uint64_t>(limits.maxNodes / 2, 1) : 0;
+        hasDeadline = limits.timeMs > 0;
+        deadline = start + std::chrono::milliseconds(limits.timeMs / 2);
+        int move = solveMove(board);
+        stopRequest = nullptr;
+        nodeLimit = 0;
+        hasDeadline = false;
+
+        // After a stop request the move is ignored, so don't search on
+        if (!stopped || (limits.stop && limits.stop->load(std::memory_order_relaxed))) {
+            return move;
+        }
+    }
+
+    // The fallback gets whatever budget the solver left
+    SearchLimits fallbackLimits = limits;
+    fallbackLimits.maxDepth = limits.maxDepth > 0 ? limits.maxDepth : MAX_BOARD_CELLS;
+    if (limits.timeMs > 0) {
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+        fallbackLimits.timeMs = std::max<std::int64_t>(limits.timeMs - elapsed.count(), 1);
+    }
+    if (limits.maxNodes > 0) {
+        std::uint64_t used = nodeCount - nodesBefore;
+        fallbackLimits.maxNodes = used < limits.maxNodes ? limits.maxNodes - used : 1;
+    }
+
+    int side = board.getMoveCount() % 2;
+    std::unique_ptr<BasicMinimaxAI<BoardT>>& fallback = fallbacks[side];
+    if (!fallback) {
+        fallback = std::make_unique<BasicMinimaxAI<BoardT>>(fallbackLimits.maxDepth, side == 0 ? 'X' : 'O');
+    }
+    int move = fallback->selectMove(board, fallbackLimits);
+    nodeCount += fallback->getNodeCount();
+    return move;
+}
+
+template <typename BoardT>
+int BasicSolverAI<BoardT>::solveMove(const BoardT& board) {
+    using Bits = SolverBits<BoardT>;
+    int moves = board.getMoveCount();
+    char toMove = (moves % 2 == 0) ? 'X' : 'O';
+    Bitboard mask = board.getOccupiedMask();
+    Bitboard current = board.getPlayerMask(toMove);
+    stopped = false;
+
+    // Take an immediate win without searching anything
+    Bitboard wins = Bits::winningCells(current, mask) & Bits::playableCells(mask);
+    for (int i = 0; wins && i < Bits::WIDTH; i++) {
+        int col = BoardT::centerOutColumn(i);
+        if (wins & Bits::columnMask(col)) {
+            return col;
+        }
+    }
+
+    int bestMove = -1;
+    int bestScore = 0;
+
+    for (int i = 0; i < Bits::WIDTH && !stopped; i++) {
+        int col = BoardT::centerOutColumn(i);
+        if (board.isColumnFull(col)) {
+            continue;
+        }
+
+        Bitboard move = Bits::playableCells(mask) & Bits::columnMask(col);
+        int score = 0;
+        if (moves + 1 < Bits::CELLS) {
+            // After the move the opponent is the player to move
+            score = -solvePosition(current ^ mask, mask | move, moves + 1);
+        }
+
+        if (bestMove < 0 || score > bestScore) {
+            bestMove = col;
+            bestScore = score;
+        }
+    }
+
+    return bestMove;
+}
+
+template <typename BoardT>
+int BasicSolverAI<BoardT>::selectMove(const BoardT& board, const SearchLimits& limits, SearchStats* stats) {
+    std::uint64_t nodesBefore = nodeCount;
+    int move = BasicAIPlayer<BoardT>::selectMove(board, limits, stats);
+    if (stats) {
+        stats->nodes = nodeCount - nodesBefore;
+    }
+    return move;
+}
+
+template <typename BoardT>
+void BasicSolverAI<BoardT>::newGame(std::uint32_t seed) {
+    transpositionTable.clear();
+    for (std::unique_ptr<BasicMinimaxAI<BoardT>>& fallback : fallbacks) {
+        if (fallback) {
+            fallback->newGame(seed);
+        }
+    }
+}
+
+template <typename BoardT>
+typename BasicSolverAI<BoardT>::SolveResult BasicSolverAI<BoardT>::solve(const BoardT& board) {
+    using Bits = SolverBits<BoardT>;
+    int moves = board.getMoveCount();
+    char toMove = (moves % 2 == 0) ? 'X' : 'O';
+
+    SolveResult result;
+    stopped = false;
+    bool inBook = false;
+    if constexpr (std::is_same<BoardT, Board>::value) {
+        // Books only cover the standard board
+        int bookMove;
+        inBook = this->openingBook && this->openingBook->probe(board, bookMove, result.score);
+    }
+    if (!inBook) {
+        result.score = solvePosition(board.getPlayerMask(toMove), board.getOccupiedMask(), moves);
+    }
+
+    // Pieces each side already has on the board
+    int ownPieces = moves / 2;
+    int opponentPieces = (moves + 1) / 2;
+
+    if (result.score > 0) {
+        int winningPiece = Bits::CELLS / 2 + 1 - result.score;
+        result.pliesToEnd = 2 * (winningPiece - ownPieces) - 1;
+    } else if (result.score < 0) {
+        int winningPiece = Bits::CELLS / 2 + 1 + result.score;
+        result.pliesToEnd = 2 * (winningPiece - opponentPieces);
+    } else {
+        result.pliesToEnd = Bits::CELLS - moves;
+    }
+    return result;
+}
+
+template <typename BoardT>
+std::uint64_t BasicSolverAI<BoardT>::getNodeCount() const {
+    return nodeCount;
+}
+
+template <typename BoardT>
+int BasicSolverAI<BoardT>::solvePosition(Bitboard current, Bitboard mask, int moves) {
+    using Bits = SolverBits<BoardT>;
+    if (Bits::canWinNext(current, mask)) {
+        return (Bits::CELLS + 1 - moves) / 2;
+    }
+
+    int min = -(Bits::CELLS - moves) / 2;
+    int max = (Bits::CELLS + 1 - moves) / 2;
+
+    // Narrow the score range with null-window searches, probing close to
+    // zero first since most positions are close games
+    while (min < max) {
+        int med = min + (max - min) / 2;
+        if (med <= 0 && min / 2 < med) {
+            med = min / 2;
+        } else if (med >= 0 && max / 2 > med) {
+            med = max / 2;
+        }
+
+        int score = negamax(current, mask, moves, med, med + 1);
+        if (stopped) {
+            break;
+        }
+        if (score <= med) {
+            max = score;
+        } else {
+            min = score;
+        }
+    }
+    return min;
+}
+
+template <typename BoardT>
+int BasicSolverAI<BoardT>::negamax(Bitboard current, Bitboard mask, int moves, int alpha, int beta) {
+    using Bits = SolverBits<BoardT>;
+    nodeCount++;
+    if ((stopRequest && stopRequest->load(std::memory_order_relaxed)) || (nodeLimit > 0 && nodeCount >= nodeLimit)) {
+        stopped = true;
+    } else if (hasDeadline && (nodeCount & 1023) == 0 && std::chrono::steady_clock::now() >= deadline) {
+        // Reading the clock is comparatively slow, so only do it periodically
+        stopped = true;
+    }
+    if (stopped) {
+        return 0;
+    }
+
+    // Callers guarantee the player to move cannot win immediately
+    Bitboard candidates = Bits::nonLosingMoves(current, mask);
+    if (candidates == 0) {
+        return -(Bits::CELLS - moves) / 2;
+    }
+
+    if (moves >= Bits::CELLS - 2) {
+        return 0;
+    }
+
+    // The opponent cannot win on their next move, so tighten the window
+    int min = -(Bits::CELLS - 2 - moves) / 2;
+    if (alpha < min) {
+        alpha = min;
+        if (alpha >= beta) {
+            return alpha;
+        }
+    }
+
+    int max = (Bits::CELLS - 1 - moves) / 2;
+    if (beta > max) {
+        beta = max;
+        if (alpha >= beta) {
+            return beta;
+        }
+    }
+
+    std::uint64_t key = Bits::positionKey(current, mask);
+    TranspositionTable::Entry entry;
+    if (transpositionTable.probe(key, entry)) {
+        if (entry.bound == TranspositionTable::Bound::LOWER) {
+            if (alpha < entry.score) {
+                alpha = entry.score;
+                if (alpha >= beta) {
+                    return alpha;
+                }
+            }
+        } else if (beta > entry.score) {
+            beta = entry.score;
+            if (alpha >= beta) {
+                return beta;
+            }
+        }
+    }
+
+    // Order moves by how many winning cells they create, center-out on ties
+    Bitboard ordered[Bits::WIDTH];
+    int priorities[Bits::WIDTH];
+    int count = 0;
+    for (int i = 0; i < Bits::WIDTH; i++) {
+        Bitboard move = candidates & Bits::columnMask(BoardT::centerOutColumn(i));
+        if (!move) {
+            continue;
+        }
+
+        int priority = popcount(Bits::winningCells(current | move, mask));
+        int j = count++;
+        while (j > 0 && priorities[j - 1] < priority) {
+            ordered[j] = ordered[j - 1];
+            priorities[j] = priorities[j - 1];
+            j--;
+        }
+        ordered[j] = move;
+        priorities[j] = priority;
+    }
+
+    for (int i = 0; i < count; i++) {
+        int score = -negamax(current ^ mask, mask | ordered[i], moves + 1, -beta, -alpha);
+
+        // An abandoned subtree's score is meaningless and must not be stored
+        if (stopped) {
+            return 0;
+        }
+        if (score >= beta) {
+            transpositionTable.store(key, score, 0, TranspositionTable::Bound::LOWER, -1);
+            return score;
+        }
+        if (score > alpha) {
+            alpha = score;
+        }
+    }
+
+    transpositionTable.store(key, alpha, 0, TranspositionTable::Bound::UPPER, -1);
+    return alpha;
+}
+
+// The variants aliased in Board.h
+template class BasicSolverAI<Board>;
+template class BasicSolverAI<Board8x7>;
+template class BasicSolverAI<Board9x7>;
+template class BasicSolverAI<Board9x6Connect5>;
@@ -0,0 +1,68 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(int threads) : running(0), stopping(false) {
+    if (threads <= 0) {
+        threads = static_cast<int>(std::thread::hardware_concurrency());
+        if (threads <= 0) {
+            threads = 1;
+        }
+    }
+
+    for (int i = 0; i < threads; i++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    taskAvailable.notify_all();
+
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(std::move(task));
+    }
+    taskAvailable.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    allDone.wait(lock, [this]() { return tasks.empty() && running == 0; });
+}
+
+int ThreadPool::size() const {
+    return static_cast<int>(workers.size());
+}
+
+void ThreadPool::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        taskAvailable.wait(lock, [this]() { return stopping || !tasks.empty(); });
+
+        // Queued work is still run when stopping
+        if (tasks.empty()) {
+            return;
+        }
+
+        std::function<void()> task = std::move(tasks.front());
+        tasks.pop_front();
+        running++;
+
+        lock.unlock();
+        task();
+        lock.lock();
+
+        running--;
+        if (tasks.empty() && running == 0) {
+            allDone.notify_all();
+        }
+    }
+}
@@ -0,0 +1,111 @@
+#include "TranspositionTable.h"
+
+namespace {
+
+// The generation lives in the otherwise unused top byte of a packed entry
+const int GENERATION_SHIFT = 56;
+
+} // namespace
+
+TranspositionTable::TranspositionTable(std::size_t sizeInMB) : slotCount(0), indexShift(64), generation(0) {
+    std::size_t maxEntries = sizeInMB * 1024 * 1024 / sizeof(Slot);
+    if (maxEntries == 0) {
+        return;
+    }
+
+    // Largest power of two that fits in the budget
+    std::size_t count = 1;
+    int bits = 0;
+    while (count * 2 <= maxEntries) {
+        count *= 2;
+        bits++;
+    }
+
+    slots.reset(new Slot[count]);
+    slotCount = count;
+    indexShift = 64 - bits;
+    wipe();
+}
+
+bool TranspositionTable::probe(std::uint64_t key, Entry& entry) const {
+    if (slotCount == 0) {
+        return false;
+    }
+
+    const Slot& slot = slots[indexOf(key)];
+    std::uint64_t data = slot.data.load(std::memory_order_relaxed);
+    std::uint64_t check = slot.check.load(std::memory_order_relaxed);
+    if ((check ^ data) != key || (data >> GENERATION_SHIFT) != generation) {
+        return false;
+    }
+
+    entry.key = key;
+    unpack(data, entry);
+    return true;
+}
+
+void TranspositionTable::store(std::uint64_t key, int score, int depth, Bound bound, int bestMove) {
+    if (slotCount == 0) {
+        return;
+    }
+
+    Slot& slot = slots[indexOf(key)];
+    std::uint64_t oldData = slot.data.load(std::memory_order_relaxed);
+    std::uint64_t oldCheck = slot.check.load(std::memory_order_relaxed);
+    if ((oldCheck ^ oldData) == key && (oldData >> GENERATION_SHIFT) == generation) {
+        Entry existing;
+        unpack(oldData, existing);
+        if (existing.depth > depth) {
+            return;
+        }
+    }
+
+    std::uint64_t data = pack(score, depth, bound, bestMove) |
+                         static_cast<std::uint64_t>(generation) << GENERATION_SHIFT;
+    slot.data.store(data, std::memory_order_relaxed);
+    slot.check.store(key ^ data, std::memory_order_relaxed);
+}
+
+void TranspositionTable::clear() {
+    generation++;
+    if (generation == 0) {
+        // Slots from 256 generations ago would match again
+        wipe();
+    }
+}
+
+void TranspositionTable::wipe() {
+    // An all-zero slot decodes to key 0, which never occurs: every exact
+    // position key has a marker bit per column, and a hashed one is 0 only
+    // with negligible probability
+    for (std::size_t i = 0; i < slotCount; i++) {
+        slots[i].data.store(0, std::memory_order_relaxed);
+        slots[i].check.store(0, std::memory_order_relaxed);
+    }
+}
+
+std::size_t TranspositionTable::size() const {
+    return slotCount;
+}
+
+std::size_t TranspositionTable::indexOf(std::uint64_t key) const {
+    if (indexShift >= 64) {
+        return 0;
+    }
+    // Fibonacci hashing spreads the structured bitboard keys over the table
+    return static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ULL) >> indexShift);
+}
+
+std::uint64_t TranspositionTable::pack(int score, int depth, Bound bound, int bestMove) {
+    return static_cast<std::uint64_t>(static_cast<std::uint32_t>(score)) |
+           static_cast<std::uint64_t>(static_cast<std::uint8_t>(depth)) << 32 |
+           static_cast<std::uint64_t>(static_cast<std::uint8_t>(bound)) << 40 |
+           static_cast<std::uint64_t>(static_cast<std::uint8_t>(bestMove)) << 48;
+}
+
+void TranspositionTable::unpack(std::uint64_t data, Entry& entry) {
+    entry.score = static_cast<std::int32_t>(static_cast<std::uint32_t>(data));
+    entry.depth = static_cast<std::int8_t>(static_cast<std::uint8_t>(data >> 32));
+    entry.bound = static_cast<Bound>(static_cast<std::uint8_t>(data >> 40));
+    entry.bestMove = static_cast<std::int8_t>(static_cast<std::uint8_t>(data >> 48));
+}
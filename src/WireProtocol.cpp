@@ -0,0 +1,152 @@
+#include "WireProtocol.h"
+#include "BitUtils.h"
+
+namespace {
+
+const std::size_t HEADER_SIZE = WireProtocol::LENGTH_SIZE + 1;
+const unsigned char NO_COLUMN = 0xFF;
+
+// Body size of each message type, or 0 for an unknown type
+std::size_t bodySize(MessageType type) {
+    switch (type) {
+        case MessageType::NEW_GAME:
+            return 3;
+        case MessageType::MOVE:
+            return 9;
+        case MessageType::CLOSE_GAME:
+        case MessageType::PING:
+        case MessageType::PONG:
+            return 8;
+        case MessageType::GAME_STATE:
+            return 28;
+        case MessageType::ERROR:
+            return 10;
+    }
+    return 0;
+}
+
+} // namespace
+
+void WireProtocol::encode(const WireMessage& message, std::vector<unsigned char>& out) {
+    std::size_t body = bodySize(message.type);
+    std::size_t start = out.size();
+    out.resize(start + HEADER_SIZE + body);
+
+    unsigned char* frame = &out[start];
+    frame[0] = static_cast<unsigned char>(body + 1);
+    frame[1] = 0;
+    frame[2] = static_cast<unsigned char>(message.type);
+    unsigned char* bytes = frame + HEADER_SIZE;
+
+    switch (message.type) {
+        case MessageType::NEW_GAME:
+            bytes[0] = static_cast<unsigned char>(message.aiPlayer);
+            bytes[1] = static_cast<unsigned char>(message.engine.kind);
+            bytes[2] = static_cast<unsigned char>(message.engine.depth);
+            break;
+        case MessageType::MOVE:
+            writeLittleEndian64(bytes, message.session);
+            bytes[8] = static_cast<unsigned char>(message.column);
+            break;
+        case MessageType::CLOSE_GAME:
+            writeLittleEndian64(bytes, message.session);
+            break;
+        case MessageType::PING:
+        case MessageType::PONG:
+            writeLittleEndian64(bytes, message.token);
+            break;
+        case MessageType::GAME_STATE:
+            writeLittleEndian64(bytes, message.session);
+            writeLittleEndian64(bytes + 8, message.xMask);
+            writeLittleEndian64(bytes + 16, message.oMask);
+            bytes[24] = static_cast<unsigned char>(message.moveCount);
+            bytes[25] = message.column < 0 ? NO_COLUMN : static_cast<unsigned char>(message.column);
+            bytes[26] = static_cast<unsigned char>(message.toMove);
+            bytes[27] = static_cast<unsigned char>(message.result);
+            break;
+        case MessageType::ERROR:
+            writeLittleEndian64(bytes, message.session);
+            bytes[8] = static_cast<unsigned char>(message.error);
+            bytes[9] = static_cast<unsigned char>(message.rejected);
+            break;
+    }
+}
+
+DecodeStatus WireProtocol::decode(const unsigned char* data, std::size_t size, WireMessage& message,
+                                  std::size_t& consumed) {
+    if (size < HEADER_SIZE) {
+        return DecodeStatus::INCOMPLETE;
+    }
+
+    // The length is checked against the type before waiting for the rest
+    // of the frame, so a corrupt length can't make the reader buffer more
+    std::size_t length = data[0] | static_cast<std::size_t>(data[1]) << 8;
+    MessageType type = static_cast<MessageType>(data[2]);
+    std::size_t body = bodySize(type);
+    if (body == 0 || length != body + 1) {
+        return DecodeStatus::MALFORMED;
+    }
+    if (size < HEADER_SIZE + body) {
+        return DecodeStatus::INCOMPLETE;
+    }
+
+    const unsigned char* bytes = data + HEADER_SIZE;
+    message.type = type;
+    switch (type) {
+        case MessageType::NEW_GAME:
+            if (bytes[1] > static_cast<unsigned char>(EngineSpec::Kind::SOLVER) || bytes[2] < 1 ||
+                bytes[2] > MAX_BOARD_CELLS) {
+                return DecodeStatus::MALFORMED;
+            }
+            message.aiPlayer = static_cast<char>(bytes[0]);
+            message.engine.kind = static_cast<EngineSpec::Kind>(bytes[1]);
+            message.engine.depth = bytes[2];
+            break;
+        case MessageType::MOVE:
+            message.session = readLittleEndian64(bytes);
+            message.column = bytes[8];
+            break;
+        case MessageType::CLOSE_GAME:
+            message.session = readLittleEndian64(bytes);
+            break;
+        case MessageType::PING:
+        case MessageType::PONG:
+            message.token = readLittleEndian64(bytes);
+            break;
+        case MessageType::GAME_STATE:
+            message.session = readLittleEndian64(bytes);
+            message.xMask = readLittleEndian64(bytes + 8);
+            message.oMask = readLittleEndian64(bytes + 16);
+            message.moveCount = bytes[24];
+            message.column = bytes[25] == NO_COLUMN ? -1 : bytes[25];
+            message.toMove = static_cast<char>(bytes[26]);
+            message.result = static_cast<char>(bytes[27]);
+            break;
+        case MessageType::ERROR:
+            message.session = readLittleEndian64(bytes);
+            message.error = static_cast<WireError>(bytes[8]);
+            message.rejected = static_cast<MessageType>(bytes[9]);
+            break;
+    }
+
+    consumed = HEADER_SIZE + body;
+    return DecodeStatus::COMPLETE;
+}
+
+void WireProtocol::snapshot(const PackedGameState& state, WireMessage& message) {
+    message.type = MessageType::GAME_STATE;
+    message.xMask = state.getPlayerMask('X');
+    message.oMask = state.getPlayerMask('O');
+    message.moveCount = state.getMoveCount();
+    message.column = state.getLastMove();
+    message.toMove = state.getCurrentPlayer();
+    message.result = state.isGameOver() ? state.getWinner() : '?';
+}
+
+bool WireProtocol::isColumnFull(const WireMessage& state, int column) {
+    if (column < 0 || column >= Board::COLS) {
+        return true;
+    }
+    std::uint64_t top = std::uint64_t(1) << (column * Board::COLUMN_BITS + Board::ROWS - 1);
+    return ((state.xMask | state.oMask) & top) != 0;
+}
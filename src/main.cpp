@@ -1,13 +1,27 @@
 #include "GameUI.h"
 #include <iostream>
+#include <string>
 
 int main(int argc, char* argv[]) {
-    // Suppress unused parameter warnings
-    (void)argc;
-    (void)argv;
-    
     GameUI gameUI;
     
+    // Opening book: --book <path>, otherwise connect4.book if present
+    // --continuous: redraw at ~60 FPS instead of only after changes
+    std::string bookPath = "connect4.book";
+    bool bookRequested = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--book" && i + 1 < argc) {
+            bookPath = argv[++i];
+            bookRequested = true;
+        } else if (arg == "--continuous") {
+            gameUI.setContinuousRendering(true);
+        }
+    }
+    if (!gameUI.loadOpeningBook(bookPath) && bookRequested) {
+        std::cerr << "Failed to open opening book: " << bookPath << std::endl;
+    }
+    
     if (!gameUI.init()) {
         std::cerr << "Failed to initialize game UI!" << std::endl;
         return 1;
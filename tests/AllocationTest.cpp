@@ -0,0 +1,130 @@
+#include "Board.h"
+#include "CountingAllocator.h"
+#include "MinimaxAI.h"
+#include "OpeningBook.h"
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * Checks that MinimaxAI searches without touching the heap
+ * Every heap allocation of the process is counted by the operator new in
+ * CountingAllocator.cpp. Once an engine and its SearchStats exist,
+ * selectMove (with statistics, hitting and missing the opening book) and
+ * selectMoves must not allocate at all, on one search thread or several.
+ *
+ * Usage: connect4_alloc_test (run by ctest; exits with 1 on failure)
+ */
+
+namespace {
+
+// Openings and early middle games as 0-based column sequences; the first
+// two are in the test book, the others are searched
+const char* const POSITIONS[] = {
+    "", "3", "33", "3342", "332415", "33221144", "3321045562", "332244115566"
+};
+
+const char* const BOOK_PATH = "connect4_alloc_test.book";
+const int SEARCH_DEPTH = 6;
+const std::size_t TT_SIZE_MB = 1;
+
+char playerToMove(const Board& board) {
+    return (board.getMoveCount() % 2 == 0) ? 'X' : 'O';
+}
+
+Board boardFromMoves(const char* moves) {
+    Board board;
+    for (const char* c = moves; *c; c++) {
+        board.dropPiece(*c - '0', playerToMove(board));
+    }
+    return board;
+}
+
+/**
+ * Writes a book of the empty board and every first move; the moves in it
+ * don't matter here, only that lookups hit
+ */
+bool writeBook(const std::string& path) {
+    std::vector<OpeningBook::Entry> entries;
+    std::vector<Board> positions(1);
+    for (int col = 0; col < Board::COLS; col++) {
+        positions.push_back(Board());
+        positions.back().dropPiece(col, 'X');
+    }
+    for (const Board& board : positions) {
+        bool mirrored;
+        std::uint64_t key = OpeningBook::canonicalKey(board, mirrored);
+        bool known = false;
+        for (const OpeningBook::Entry& entry : entries) {
+            known = known || entry.key == key;
+        }
+        if (!known) {
+            entries.push_back(OpeningBook::Entry{key, Board::COLS / 2, 0});
+        }
+    }
+    return OpeningBook::write(path, entries, 1);
+}
+
+/**
+ * Searches every position with one engine per color
+ * @return Heap allocations made by the searches
+ */
+std::uint64_t countSearchAllocations(int threads, const std::shared_ptr<const OpeningBook>& book) {
+    std::vector<Board> positions[2];
+    for (const char* moves : POSITIONS) {
+        Board board = boardFromMoves(moves);
+        positions[board.getMoveCount() % 2].push_back(board);
+    }
+    MinimaxAI engines[2] = {
+        MinimaxAI(SEARCH_DEPTH, 'X', TT_SIZE_MB, threads),
+        MinimaxAI(SEARCH_DEPTH, 'O', TT_SIZE_MB, threads)
+    };
+    std::vector<int> moves(positions[0].size() + positions[1].size());
+    SearchStats stats;
+    stats.reset();
+
+    SearchLimits limits;
+    limits.maxDepth = SEARCH_DEPTH;
+    std::uint64_t before = allocationCount();
+    for (int side = 0; side < 2; side++) {
+        engines[side].setOpeningBook(book);
+        for (const Board& board : positions[side]) {
+            engines[side].selectMove(board, limits, &stats);
+        }
+        engines[side].selectMoves(positions[side].data(), moves.data(), positions[side].size(), limits);
+    }
+    std::uint64_t allocations = allocationCount() - before;
+
+    // Detaching the book drops a reference, so do it outside the count
+    for (MinimaxAI& engine : engines) {
+        engine.setOpeningBook(nullptr);
+    }
+    return allocations;
+}
+
+} // namespace
+
+int main() {
+    if (!writeBook(BOOK_PATH)) {
+        std::fprintf(stderr, "cannot write %s\n", BOOK_PATH);
+        return 1;
+    }
+    auto book = std::make_shared<OpeningBook>();
+    if (!book->open(BOOK_PATH)) {
+        std::fprintf(stderr, "cannot open %s\n", BOOK_PATH);
+        return 1;
+    }
+
+    bool passed = true;
+    for (int threads : {1, 2, 4}) {
+        std::uint64_t allocations = countSearchAllocations(threads, book);
+        std::printf("%d search thread%s: %llu allocations\n", threads, threads == 1 ? "" : "s",
+                    static_cast<unsigned long long>(allocations));
+        passed = passed && allocations == 0;
+    }
+
+    book->close();
+    std::remove(BOOK_PATH);
+    return passed ? 0 : 1;
+}
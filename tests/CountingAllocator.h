@@ -0,0 +1,14 @@
+#ifndef COUNTINGALLOCATOR_H
+#define COUNTINGALLOCATOR_H
+
+#include <cstdint>
+
+/**
+ * Heap allocations made by the process so far
+ * Linking CountingAllocator.cpp replaces the global operator new and delete
+ * with versions that count every allocation; used by the allocation test and
+ * the benchmarks.
+ */
+std::uint64_t allocationCount();
+
+#endif // COUNTINGALLOCATOR_H
@@ -0,0 +1,334 @@
+#include "Board.h"
+#include "CountingAllocator.h"
+#include "GameRecord.h"
+#include "MinimaxAI.h"
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+/**
+ * Microbenchmarks for the board and search hot paths and game record I/O
+ * Besides time per operation, the search benchmarks report nodes per second
+ * and heap allocations per search, counted by the operator new in
+ * tests/CountingAllocator.cpp. A selectMove that allocates at all fails its
+ * benchmark.
+ *
+ * Usage: connect4_bench [Google Benchmark flags, e.g. --benchmark_filter=SelectMove]
+ */
+
+namespace {
+
+// Search corpus: openings and early middle games as 0-based column sequences
+const char* const SEARCH_CORPUS[] = {
+    "", "3", "33", "3342", "332415", "33221144", "3321045562", "332244115566"
+};
+const int SEARCH_CORPUS_SIZE = sizeof(SEARCH_CORPUS) / sizeof(SEARCH_CORPUS[0]);
+
+// Transposition table per search engine; small enough to clear between
+// searches without dominating the run time of shallow searches
+const std::size_t BENCH_TT_SIZE_MB = 1;
+
+char playerToMove(const Board& board) {
+    return (board.getMoveCount() % 2 == 0) ? 'X' : 'O';
+}
+
+Board boardFromMoves(const char* moves) {
+    Board board;
+    for (const char* c = moves; *c; c++) {
+        board.dropPiece(*c - '0', playerToMove(board));
+    }
+    return board;
+}
+
+/**
+ * Fixed set of positions from random games, stopped before anyone wins
+ */
+const std::vector<Board>& randomPositions() {
+    static const std::vector<Board> positions = []() {
+        std::vector<Board> result;
+        std::mt19937 rng(12345);
+        while (result.size() < 256) {
+            Board board;
+            int length = static_cast<int>(rng() % 36);
+            for (int i = 0; i < length; i++) {
+                int col = static_cast<int>(rng() % Board::COLS);
+                if (!board.dropPiece(col, playerToMove(board))) {
+                    continue;
+                }
+                if (board.lastMoveWins()) {
+                    board.undoMove(col);
+                    break;
+                }
+            }
+            result.push_back(board);
+        }
+        return result;
+    }();
+    return positions;
+}
+
+void BM_DropPiece(benchmark::State& state) {
+    // Fills the board column by column, then starts over
+    Board board;
+    int col = 0;
+    for (auto _ : state) {
+        if (board.isFull()) {
+            state.PauseTiming();
+            board.reset();
+            col = 0;
+            state.ResumeTiming();
+        }
+        if (board.isColumnFull(col)) {
+            col++;
+        }
+        benchmark::DoNotOptimize(board.dropPiece(col, playerToMove(board)));
+    }
+}
+BENCHMARK(BM_DropPiece);
+
+void BM_DropAndUndo(benchmark::State& state) {
+    Board board = boardFromMoves("332415");
+    int col = 0;
+    for (auto _ : state) {
+        board.dropPiece(col, 'X');
+        benchmark::DoNotOptimize(board.undoMove(col));
+        col = (col + 1) % Board::COLS;
+    }
+}
+BENCHMARK(BM_DropAndUndo);
+
+void BM_CheckWin(benchmark::State& state) {
+    const std::vector<Board>& positions = randomPositions();
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(positions[i].checkWin('X'));
+        i = (i + 1) % positions.size();
+    }
+}
+BENCHMARK(BM_CheckWin);
+
+void BM_LastMoveWins(benchmark::State& state) {
+    const std::vector<Board>& positions = randomPositions();
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(positions[i].lastMoveWins());
+        i = (i + 1) % positions.size();
+    }
+}
+BENCHMARK(BM_LastMoveWins);
+
+void BM_BoardCopy(benchmark::State& state) {
+    const std::vector<Board>& positions = randomPositions();
+    std::size_t i = 0;
+    for (auto _ : state) {
+        Board copy = positions[i];
+        benchmark::DoNotOptimize(copy);
+        i = (i + 1) % positions.size();
+    }
+}
+BENCHMARK(BM_BoardCopy);
+
+void BM_EvaluateBoard(benchmark::State& state) {
+    const std::vector<Board>& positions = randomPositions();
+    MinimaxAI ai(4, 'O', 0);
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ai.evaluateBoard(positions[i]));
+        i = (i + 1) % positions.size();
+    }
+}
+BENCHMARK(BM_EvaluateBoard);
+
+void BM_EvaluateBoardReference(benchmark::State& state) {
+    const std::vector<Board>& positions = randomPositions();
+    MinimaxAI ai(4, 'O', 0);
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ai.evaluateBoardReference(positions[i]));
+        i = (i + 1) % positions.size();
+    }
+}
+BENCHMARK(BM_EvaluateBoardReference);
+
+// Scratch file for the game record benchmarks, in the working directory
+const char* const RECORD_BENCH_PATH = "connect4_bench.records";
+
+// Games per record file written by the benchmarks
+const int RECORD_BENCH_GAMES = 1 << 16;
+
+/**
+ * Writes the random positions as RECORD_BENCH_GAMES games
+ */
+bool writeBenchRecords() {
+    const std::vector<Board>& positions = randomPositions();
+    GameRecordWriter writer;
+    if (!writer.open<Board>(RECORD_BENCH_PATH)) {
+        return false;
+    }
+    for (int i = 0; i < RECORD_BENCH_GAMES; i++) {
+        writer.write(positions[i % positions.size()], '?');
+    }
+    return writer.close();
+}
+
+/**
+ * Creating, filling and closing one record file per iteration
+ */
+void BM_WriteGameRecords(benchmark::State& state) {
+    for (auto _ : state) {
+        if (!writeBenchRecords()) {
+            state.SkipWithError("Failed to write the game record file");
+            break;
+        }
+    }
+    std::remove(RECORD_BENCH_PATH);
+    state.SetItemsProcessed(state.iterations() * RECORD_BENCH_GAMES);
+}
+BENCHMARK(BM_WriteGameRecords)->Unit(benchmark::kMicrosecond);
+
+/**
+ * Reading one game per iteration and replaying it onto a board
+ */
+void BM_ReadGameRecord(benchmark::State& state) {
+    GameRecordReader reader;
+    if (!writeBenchRecords() || !reader.open(RECORD_BENCH_PATH)) {
+        state.SkipWithError("Failed to write the game record file");
+        return;
+    }
+
+    GameRecord record;
+    for (auto _ : state) {
+        if (!reader.next(record)) {
+            reader.rewind();
+            reader.next(record);
+        }
+        Board board;
+        record.replay(board);
+        benchmark::DoNotOptimize(board);
+    }
+
+    reader.close();
+    std::remove(RECORD_BENCH_PATH);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ReadGameRecord);
+
+/**
+ * One cold search per iteration, cycling through the search corpus
+ * Arguments: depth, move ordering (0/1), search threads. Timed by the wall
+ * clock, since helper threads don't show up in the main thread's CPU time.
+ */
+void BM_SelectMove(benchmark::State& state) {
+    int depth = static_cast<int>(state.range(0));
+    bool ordering = state.range(1) != 0;
+    int threads = static_cast<int>(state.range(2));
+
+    std::vector<Board> positions;
+    for (const char* moves : SEARCH_CORPUS) {
+        positions.push_back(boardFromMoves(moves));
+    }
+
+    // One engine per color, as MinimaxAI plays a fixed side
+    MinimaxAI engines[2] = {
+        MinimaxAI(depth, 'X', BENCH_TT_SIZE_MB, threads),
+        MinimaxAI(depth, 'O', BENCH_TT_SIZE_MB, threads)
+    };
+    for (MinimaxAI& engine : engines) {
+        engine.setMoveOrdering(ordering);
+    }
+
+    std::uint64_t nodes = 0;
+    std::uint64_t allocations = 0;
+    int i = 0;
+    for (auto _ : state) {
+        const Board& board = positions[i];
+        MinimaxAI& engine = engines[board.getMoveCount() % 2];
+
+        state.PauseTiming();
+        engine.clearTranspositionTable();
+        std::uint64_t allocationsBefore = allocationCount();
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize(engine.selectMove(board));
+
+        state.PauseTiming();
+        allocations += allocationCount() - allocationsBefore;
+        nodes += engine.getNodeCount();
+        i = (i + 1) % SEARCH_CORPUS_SIZE;
+        state.ResumeTiming();
+    }
+
+    state.counters["nodes"] = benchmark::Counter(static_cast<double>(nodes), benchmark::Counter::kAvgIterations);
+    state.counters["nodes/s"] = benchmark::Counter(static_cast<double>(nodes), benchmark::Counter::kIsRate);
+    state.counters["allocs"] = benchmark::Counter(static_cast<double>(allocations), benchmark::Counter::kAvgIterations);
+
+    // The search is meant to run entirely out of memory set up by the engine
+    if (allocations > 0) {
+        state.SkipWithError("selectMove allocated heap memory");
+    }
+}
+BENCHMARK(BM_SelectMove)
+    ->ArgNames({"depth", "ordering", "threads"})
+    ->ArgsProduct({benchmark::CreateDenseRange(1, 8, 1), {0, 1}, {1}})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+BENCHMARK(BM_SelectMove)
+    ->ArgNames({"depth", "ordering", "threads"})
+    ->ArgsProduct({{8}, {1}, {2, 4}})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+/**
+ * Searching all the random positions per iteration, either one selectMove
+ * call per position or as one selectMoves batch
+ * Arguments: depth, batched (0/1), search threads. Each iteration starts
+ * with cleared tables.
+ */
+void BM_SelectMoves(benchmark::State& state) {
+    int depth = static_cast<int>(state.range(0));
+    bool batched = state.range(1) != 0;
+    int threads = static_cast<int>(state.range(2));
+
+    // Split by the side to move, as MinimaxAI plays a fixed side
+    std::vector<Board> positions[2];
+    for (const Board& board : randomPositions()) {
+        positions[board.getMoveCount() % 2].push_back(board);
+    }
+    std::unique_ptr<AIPlayer> engines[2] = {
+        std::make_unique<MinimaxAI>(depth, 'X', BENCH_TT_SIZE_MB, threads),
+        std::make_unique<MinimaxAI>(depth, 'O', BENCH_TT_SIZE_MB, threads)
+    };
+    std::vector<int> moves(randomPositions().size());
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        for (std::unique_ptr<AIPlayer>& engine : engines) {
+            static_cast<MinimaxAI&>(*engine).clearTranspositionTable();
+        }
+        state.ResumeTiming();
+
+        for (int side = 0; side < 2; side++) {
+            const std::vector<Board>& batch = positions[side];
+            if (batched) {
+                engines[side]->selectMoves(batch.data(), moves.data(), batch.size(), SearchLimits());
+            } else {
+                for (std::size_t i = 0; i < batch.size(); i++) {
+                    moves[i] = engines[side]->selectMove(batch[i], SearchLimits());
+                }
+            }
+            benchmark::DoNotOptimize(moves.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(randomPositions().size()));
+}
+BENCHMARK(BM_SelectMoves)
+    ->ArgNames({"depth", "batched", "threads"})
+    ->ArgsProduct({{4, 6}, {0, 1}, {1, 2, 4}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+} // namespace
+
+BENCHMARK_MAIN();
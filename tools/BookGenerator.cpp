@@ -0,0 +1,182 @@
+#include "Board.h"
+#include "OpeningBook.h"
+#include "SolverAI.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Opening book generator
+ * Solves every position reachable within the given number of plies and
+ * writes the best move and exact score of each to a book file that
+ * OpeningBook can memory-map.
+ *
+ * Usage: connect4_bookgen [--plies N] [--output FILE] [--tt MB] [--root MOVES]
+ *   --plies N     Include positions with up to N pieces on the board (default 6)
+ *   --output FILE Book file to write (default connect4.book)
+ *   --tt MB       Solver transposition table size (default 256)
+ *   --root MOVES  Only cover positions after this opening, given as column
+ *                 numbers 1-7 (e.g. 4453)
+ */
+
+namespace {
+
+const int CELLS = Board::ROWS * Board::COLS;
+
+char playerToMove(const Board& board) {
+    return (board.getMoveCount() % 2 == 0) ? 'X' : 'O';
+}
+
+class BookBuilder {
+public:
+    BookBuilder(int plies, std::size_t ttSizeMB) : plies(plies), solver(ttSizeMB), solvedLeaves(0) {}
+
+    /**
+     * Scores a position and, if it is within the book depth, every book
+     * position below it
+     * @return Exact score for the player to move
+     */
+    int build(Board& board) {
+        bool mirrored;
+        std::uint64_t key = OpeningBook::canonicalKey(board, mirrored);
+        auto known = entries.find(key);
+        if (known != entries.end()) {
+            return known->second.score;
+        }
+
+        int moves = board.getMoveCount();
+        char player = playerToMove(board);
+        int bestMove = -1;
+        int bestScore = 0;
+
+        // Same tie-break as SolverAI::selectMove: best score, then center-out
+        for (int i = 0; i < Board::COLS; i++) {
+            int col = Board::centerOutColumn(i);
+            Board::MoveGuard move(board, col, player);
+            if (!move.applied()) {
+                continue;
+            }
+
+            int score;
+            if (board.lastMoveWins()) {
+                score = (CELLS + 1 - moves) / 2;
+            } else if (board.isFull()) {
+                score = 0;
+            } else if (moves + 1 <= plies) {
+                score = -build(board);
+            } else {
+                score = -solver.solve(board).score;
+                solvedLeaves++;
+            }
+
+            if (bestMove < 0 || score > bestScore) {
+                bestMove = col;
+                bestScore = score;
+            }
+        }
+
+        OpeningBook::Entry entry;
+        entry.key = key;
+        entry.move = mirrored ? Board::COLS - 1 - bestMove : bestMove;
+        entry.score = bestScore;
+        entries[key] = entry;
+
+        if (entries.size() % 1000 == 0) {
+            std::cerr << entries.size() << " positions, " << solvedLeaves << " leaves solved\n";
+        }
+        return bestScore;
+    }
+
+    std::vector<OpeningBook::Entry> getEntries() const {
+        std::vector<OpeningBook::Entry> result;
+        result.reserve(entries.size());
+        for (const auto& item : entries) {
+            result.push_back(item.second);
+        }
+        return result;
+    }
+
+    std::uint64_t getSolvedLeaves() const {
+        return solvedLeaves;
+    }
+
+    std::uint64_t getNodeCount() const {
+        return solver.getNodeCount();
+    }
+
+private:
+    int plies;
+    SolverAI solver;
+    std::unordered_map<std::uint64_t, OpeningBook::Entry> entries;
+    std::uint64_t solvedLeaves;
+};
+
+void printUsage() {
+    std::cerr << "Usage: connect4_bookgen [--plies N] [--output FILE] [--tt MB] [--root MOVES]\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int plies = 6;
+    std::string output = "connect4.book";
+    std::size_t ttSizeMB = 256;
+    std::string root;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            printUsage();
+            return 1;
+        }
+        if (arg == "--plies") {
+            plies = std::atoi(argv[++i]);
+        } else if (arg == "--output") {
+            output = argv[++i];
+        } else if (arg == "--tt") {
+            ttSizeMB = static_cast<std::size_t>(std::atoi(argv[++i]));
+        } else if (arg == "--root") {
+            root = argv[++i];
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (plies < 0 || plies >= CELLS) {
+        std::cerr << "--plies must be between 0 and " << CELLS - 1 << "\n";
+        return 1;
+    }
+
+    Board board;
+    for (char c : root) {
+        int col = c - '1';
+        if (!board.dropPiece(col, playerToMove(board)) || board.lastMoveWins()) {
+            std::cerr << "Invalid --root opening: " << root << "\n";
+            return 1;
+        }
+    }
+    if (board.getMoveCount() > plies) {
+        std::cerr << "--root opening is longer than --plies\n";
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    BookBuilder builder(plies, ttSizeMB);
+    int score = builder.build(board);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<OpeningBook::Entry> entries = builder.getEntries();
+    if (!OpeningBook::write(output, entries, plies)) {
+        std::cerr << "Failed to write " << output << "\n";
+        return 1;
+    }
+
+    std::cout << "Wrote " << entries.size() << " positions to " << output << "\n";
+    std::cout << "Root score " << score << ", " << builder.getSolvedLeaves() << " leaves solved, "
+              << builder.getNodeCount() << " solver nodes, " << seconds << " s\n";
+    return 0;
+}
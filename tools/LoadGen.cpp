@@ -0,0 +1,572 @@
+#include "EngineSpec.h"
+#include "GameRecord.h"
+#include "LatencyHistogram.h"
+#include "WireProtocol.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <random>
+#include <sstream>
+#include <string>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+/**
+ * Load generator for connect4_server (Linux only)
+ * Opens N client connections, each playing one game after another with
+ * random legal moves (or moves from a game record file), and measures the
+ * round trip of every move: from sending MOVE to receiving the resulting
+ * GAME_STATE. Against an AI opponent it also measures the time until the
+ * AI's reply arrives. Latencies go into LatencyHistogram, so percentiles
+ * stay accurate to 1% however long the run.
+ *
+ * With --sweep the run is repeated for each client count and a table shows
+ * where throughput stops growing and latency starts to climb.
+ *
+ * Usage: connect4_loadgen [options]
+ *   --host ADDR       Server address (default 127.0.0.1)
+ *   --port N          Server port (default 4444)
+ *   --clients N       Simulated clients (default 100)
+ *   --sweep LIST      Client counts to run in turn, e.g. 1,10,100,1000
+ *   --duration S      Measured seconds per run (default 10)
+ *   --warmup S        Unmeasured seconds before each run (default 1)
+ *   --threads N       Client threads (default 1)
+ *   --engine SPEC     AI opponent, or "none" to play both sides (default random)
+ *   --script FILE     Play both sides from the games in a game record file
+ *   --seed N          Seed for the clients' moves (default 1)
+ * Engine specs: none, random, minimax[:depth], solver
+ */
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    std::string host = "127.0.0.1";
+    int port = 4444;
+    std::vector<int> clientCounts = {100};
+    double durationSeconds = 10.0;
+    double warmupSeconds = 1.0;
+    int threads = 1;
+    bool aiOpponent = true;
+    EngineSpec engine;
+    std::string scriptPath;
+    std::uint32_t seed = 1;
+};
+
+// Measurements of one client thread, merged after the run
+struct Measurements {
+    LatencyHistogram moveLatency; // MOVE sent to its GAME_STATE received
+    LatencyHistogram aiLatency;   // Move sent to the AI's reply received
+    std::uint64_t moves = 0;      // Moves played by both sides
+    std::uint64_t games = 0;
+    std::uint64_t errors = 0;
+    std::uint64_t disconnects = 0;
+
+    void merge(const Measurements& other) {
+        moveLatency.merge(other.moveLatency);
+        aiLatency.merge(other.aiLatency);
+        moves += other.moves;
+        games += other.games;
+        errors += other.errors;
+        disconnects += other.disconnects;
+    }
+};
+
+struct Client {
+    int fd = -1;
+    std::vector<unsigned char> input;
+    std::vector<unsigned char> output;
+    std::mt19937 rng;
+    char aiPlayer = ' ';
+    std::uint64_t session = 0;
+    bool inGame = false;        // session is open on the server
+    bool awaitingReply = false; // A NEW_GAME or MOVE hasn't been answered yet
+    bool movePending = false;   // The request awaiting its reply is a MOVE
+    Clock::time_point sentAt;   // When the last NEW_GAME or MOVE was sent
+    const GameRecord* script = nullptr;
+    int scriptPly = 0;
+};
+
+// Games shared by all clients in --script mode
+struct Script {
+    GameRecordReader reader;
+    std::vector<GameRecord> games;
+    std::atomic<std::uint64_t> next{0};
+
+    const GameRecord* take() {
+        return games.empty() ? nullptr : &games[next++ % games.size()];
+    }
+};
+
+class ClientThread {
+public:
+    ClientThread(const Options& options, Script* script, int clientCount, std::uint32_t seed)
+        : options(options), script(script), clientCount(clientCount), seed(seed), epollFd(-1) {}
+
+    ~ClientThread() {
+        for (Client& client : clients) {
+            if (client.fd >= 0) {
+                ::close(client.fd);
+            }
+        }
+        if (epollFd >= 0) {
+            ::close(epollFd);
+        }
+    }
+
+    // Connects all clients; runs on the calling thread before the clock starts
+    bool connectClients(const sockaddr_in& address) {
+        epollFd = epoll_create1(EPOLL_CLOEXEC);
+        if (epollFd < 0) {
+            std::perror("connect4_loadgen: epoll_create1");
+            return false;
+        }
+
+        clients.resize(clientCount);
+        for (int i = 0; i < clientCount; i++) {
+            Client& client = clients[i];
+            client.fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            if (client.fd < 0 || connect(client.fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0) {
+                std::perror("connect4_loadgen: connect");
+                return false;
+            }
+            int noDelay = 1;
+            setsockopt(client.fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+            epoll_event event{};
+            event.events = EPOLLIN;
+            event.data.u32 = static_cast<std::uint32_t>(i);
+            if (epoll_ctl(epollFd, EPOLL_CTL_ADD, client.fd, &event) < 0) {
+                std::perror("connect4_loadgen: epoll_ctl");
+                return false;
+            }
+            client.rng.seed(seed + static_cast<std::uint32_t>(i) * 7919u);
+        }
+        return true;
+    }
+
+    /**
+     * Plays until stop is set, measuring from measureFrom on
+     */
+    void run(const std::atomic<bool>& stop, Clock::time_point measureFrom) {
+        this->measureFrom = measureFrom;
+        for (Client& client : clients) {
+            newGame(client, Clock::now());
+            flush(client);
+        }
+
+        epoll_event events[256];
+        std::vector<unsigned char> readBuffer(1 << 16);
+        while (!stop) {
+            int count = epoll_wait(epollFd, events, 256, 100);
+            for (int i = 0; i < count; i++) {
+                Client& client = clients[events[i].data.u32];
+                if (client.fd >= 0 && !receive(client, readBuffer, Clock::now())) {
+                    ::close(client.fd);
+                    client.fd = -1;
+                    measurements.disconnects++;
+                }
+            }
+        }
+    }
+
+    const Measurements& getMeasurements() const {
+        return measurements;
+    }
+
+private:
+    const Options& options;
+    Script* script;
+    int clientCount;
+    std::uint32_t seed;
+    int epollFd;
+    std::vector<Client> clients;
+    Clock::time_point measureFrom;
+    Measurements measurements;
+
+    bool measuring(Clock::time_point now) const {
+        return now >= measureFrom;
+    }
+
+    bool receive(Client& client, std::vector<unsigned char>& buffer, Clock::time_point now) {
+        ssize_t received = recv(client.fd, buffer.data(), buffer.size(), MSG_DONTWAIT);
+        if (received <= 0) {
+            return received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR);
+        }
+        client.input.insert(client.input.end(), buffer.data(), buffer.data() + received);
+
+        std::size_t offset = 0;
+        WireMessage message;
+        while (true) {
+            std::size_t consumed = 0;
+            DecodeStatus status =
+                WireProtocol::decode(client.input.data() + offset, client.input.size() - offset, message, consumed);
+            if (status == DecodeStatus::MALFORMED) {
+                return false;
+            }
+            if (status == DecodeStatus::INCOMPLETE) {
+                break;
+            }
+            offset += consumed;
+            if (!handle(client, message, now)) {
+                return false;
+            }
+        }
+        client.input.erase(client.input.begin(), client.input.begin() + offset);
+        return flush(client);
+    }
+
+    /**
+     * @return False if the client should give up and disconnect
+     */
+    bool handle(Client& client, const WireMessage& message, Clock::time_point now) {
+        std::uint64_t nanos = static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(now - client.sentAt).count());
+
+        if (message.type == MessageType::ERROR) {
+            // Not expected from a healthy server. A refused NEW_GAME would
+            // only be refused again, so that client gives up; otherwise it
+            // closes its game, so errors don't leave sessions behind, and
+            // starts over
+            measurements.errors++;
+            client.awaitingReply = false;
+            if (message.error == WireError::AI_FAILED) {
+                client.inGame = false; // Already closed by the server
+            }
+            if (message.rejected == MessageType::NEW_GAME) {
+                return false;
+            }
+            closeGame(client);
+            newGame(client, now);
+            return true;
+        }
+        if (message.type != MessageType::GAME_STATE) {
+            return true;
+        }
+        client.session = message.session;
+        client.inGame = true;
+
+        if (client.awaitingReply) {
+            client.awaitingReply = false;
+            if (client.movePending && measuring(now)) {
+                measurements.moveLatency.record(nanos);
+                measurements.moves++;
+            }
+        } else if (measuring(now)) {
+            // Anything else is the AI's move, timed from the request it answers
+            measurements.aiLatency.record(nanos);
+            measurements.moves++;
+        }
+
+        if (message.result != '?') {
+            if (measuring(now)) {
+                measurements.games++;
+            }
+            closeGame(client);
+            newGame(client, now);
+        } else if (message.toMove != client.aiPlayer && !client.awaitingReply) {
+            play(client, message, now);
+        }
+        return true;
+    }
+
+    void closeGame(Client& client) {
+        if (!client.inGame) {
+            return;
+        }
+        WireMessage close;
+        close.type = MessageType::CLOSE_GAME;
+        close.session = client.session;
+        WireProtocol::encode(close, client.output);
+        client.inGame = false;
+    }
+
+    void newGame(Client& client, Clock::time_point now) {
+        WireMessage request;
+        request.type = MessageType::NEW_GAME;
+        request.engine = options.engine;
+        request.aiPlayer = ' ';
+        if (options.aiOpponent) {
+            request.aiPlayer = (client.rng() & 1) ? 'X' : 'O';
+        } else if (script) {
+            client.script = script->take();
+            client.scriptPly = 0;
+        }
+        client.aiPlayer = request.aiPlayer;
+        WireProtocol::encode(request, client.output);
+        client.awaitingReply = true;
+        client.movePending = false;
+        client.sentAt = now;
+    }
+
+    // Picks the scripted move, or a random legal column as RandomAI would
+    void play(Client& client, const WireMessage& state, Clock::time_point now) {
+        int column = -1;
+        if (client.script && client.scriptPly < client.script->moveCount) {
+            column = client.script->getMove(client.scriptPly++);
+        }
+        if (WireProtocol::isColumnFull(state, column)) {
+            int legal[Board::COLS];
+            int legalCount = 0;
+            for (int c = 0; c < Board::COLS; c++) {
+                if (!WireProtocol::isColumnFull(state, c)) {
+                    legal[legalCount++] = c;
+                }
+            }
+            column = legal[client.rng() % legalCount];
+        }
+
+        WireMessage request;
+        request.type = MessageType::MOVE;
+        request.session = state.session;
+        request.column = column;
+        WireProtocol::encode(request, client.output);
+        client.awaitingReply = true;
+        client.movePending = true;
+        client.sentAt = now;
+    }
+
+    // Requests are a few bytes, so the socket buffer always takes them
+    bool flush(Client& client) {
+        std::size_t sent = 0;
+        while (sent < client.output.size()) {
+            ssize_t written = ::send(client.fd, client.output.data() + sent, client.output.size() - sent, MSG_NOSIGNAL);
+            if (written < 0 && errno == EINTR) {
+                continue;
+            }
+            if (written <= 0) {
+                return false;
+            }
+            sent += static_cast<std::size_t>(written);
+        }
+        client.output.clear();
+        return true;
+    }
+};
+
+double toMicros(std::uint64_t nanos) {
+    return static_cast<double>(nanos) / 1000.0;
+}
+
+void printHistogram(const char* name, const LatencyHistogram& histogram) {
+    if (histogram.count() == 0) {
+        return;
+    }
+    std::printf("  %-12s %10llu samples  mean %9.1f  p50 %9.1f  p99 %9.1f  p99.9 %9.1f  max %9.1f us\n", name,
+                static_cast<unsigned long long>(histogram.count()), histogram.mean() / 1000.0,
+                toMicros(histogram.percentile(50.0)), toMicros(histogram.percentile(99.0)),
+                toMicros(histogram.percentile(99.9)), toMicros(histogram.max()));
+}
+
+/**
+ * Plays with the given number of clients for the warm-up and measured time
+ * @return False if the clients couldn't connect
+ */
+bool runLoad(const Options& options, Script* script, const sockaddr_in& address, int clientCount,
+             Measurements& total, double& seconds) {
+    int threadCount = std::max(1, std::min(options.threads, clientCount));
+    std::vector<std::unique_ptr<ClientThread>> threads;
+    for (int t = 0; t < threadCount; t++) {
+        int share = clientCount / threadCount + (t < clientCount % threadCount ? 1 : 0);
+        threads.push_back(std::make_unique<ClientThread>(options, script, share,
+                                                         options.seed + static_cast<std::uint32_t>(t) * 104729u));
+        if (!threads.back()->connectClients(address)) {
+            return false;
+        }
+    }
+
+    std::atomic<bool> stop(false);
+    auto warmup = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options.warmupSeconds));
+    auto duration = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options.durationSeconds));
+    Clock::time_point measureFrom = Clock::now() + warmup;
+
+    std::vector<std::thread> workers;
+    for (std::unique_ptr<ClientThread>& thread : threads) {
+        ClientThread* client = thread.get();
+        workers.emplace_back([client, &stop, measureFrom]() { client->run(stop, measureFrom); });
+    }
+    std::this_thread::sleep_until(measureFrom + duration);
+    stop = true;
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    seconds = options.durationSeconds;
+    for (std::unique_ptr<ClientThread>& thread : threads) {
+        total.merge(thread->getMeasurements());
+    }
+    return true;
+}
+
+bool parseClientCounts(const std::string& text, std::vector<int>& counts) {
+    counts.clear();
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        int count = std::atoi(item.c_str());
+        if (count <= 0) {
+            return false;
+        }
+        counts.push_back(count);
+    }
+    return !counts.empty();
+}
+
+void printUsage() {
+    std::cerr << "Usage: connect4_loadgen [--host ADDR] [--port N] [--clients N] [--sweep N,N,...]\n"
+                 "       [--duration S] [--warmup S] [--threads N] [--engine SPEC] [--script FILE] [--seed N]\n"
+                 "Engine specs: none, random, minimax[:depth], solver\n";
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    options.engine.kind = EngineSpec::Kind::RANDOM;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            return false;
+        }
+        std::string value = argv[++i];
+
+        if (arg == "--host") {
+            options.host = value;
+        } else if (arg == "--port") {
+            options.port = std::atoi(value.c_str());
+        } else if (arg == "--clients") {
+            options.clientCounts = {std::atoi(value.c_str())};
+        } else if (arg == "--sweep") {
+            if (!parseClientCounts(value, options.clientCounts)) {
+                std::cerr << "Invalid client counts: " << value << "\n";
+                return false;
+            }
+        } else if (arg == "--duration") {
+            options.durationSeconds = std::atof(value.c_str());
+        } else if (arg == "--warmup") {
+            options.warmupSeconds = std::atof(value.c_str());
+        } else if (arg == "--threads") {
+            options.threads = std::atoi(value.c_str());
+        } else if (arg == "--engine") {
+            options.aiOpponent = value != "none";
+            if (options.aiOpponent && !EngineSpec::parse(value, options.engine)) {
+                std::cerr << "Unknown engine spec: " << value << "\n";
+                return false;
+            }
+        } else if (arg == "--script") {
+            options.scriptPath = value;
+        } else if (arg == "--seed") {
+            options.seed = static_cast<std::uint32_t>(std::strtoul(value.c_str(), nullptr, 10));
+        } else {
+            return false;
+        }
+    }
+    return options.clientCounts[0] > 0 && options.durationSeconds > 0 && options.warmupSeconds >= 0 &&
+           options.threads > 0;
+}
+
+// Thousands of clients need more descriptors than the usual soft limit
+void raiseDescriptorLimit() {
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 1;
+    }
+
+    std::unique_ptr<Script> script;
+    if (!options.scriptPath.empty()) {
+        if (options.aiOpponent) {
+            std::cerr << "Scripted games play both sides: use --engine none\n";
+            return 1;
+        }
+        script = std::make_unique<Script>();
+        if (!script->reader.open(options.scriptPath) || !script->reader.isFor<Board>()) {
+            std::cerr << "Failed to open a 7x6 game record file: " << options.scriptPath << "\n";
+            return 1;
+        }
+        GameRecord record;
+        while (script->reader.next(record)) {
+            script->games.push_back(record);
+        }
+    }
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<std::uint16_t>(options.port));
+    if (inet_pton(AF_INET, options.host.c_str(), &address.sin_addr) != 1) {
+        std::cerr << "Invalid server address: " << options.host << "\n";
+        return 1;
+    }
+    raiseDescriptorLimit();
+
+    std::string opponent = options.aiOpponent ? options.engine.toString() : "none";
+    std::printf("%s:%d, opponent %s, %.1f s per run\n", options.host.c_str(), options.port, opponent.c_str(),
+                options.durationSeconds);
+    std::printf("%8s %11s %9s %10s %10s %10s %10s %10s\n", "clients", "moves/s", "games/s", "p50 us", "p99 us",
+                "p99.9 us", "max us", "AI p99 us");
+
+    double bestThroughput = 0.0;
+    std::vector<double> throughputs;
+    Measurements last;
+    for (int clientCount : options.clientCounts) {
+        Measurements total;
+        double seconds = 0.0;
+        if (!runLoad(options, script.get(), address, clientCount, total, seconds)) {
+            return 1;
+        }
+
+        double movesPerSecond = static_cast<double>(total.moves) / seconds;
+        throughputs.push_back(movesPerSecond);
+        bestThroughput = std::max(bestThroughput, movesPerSecond);
+        const LatencyHistogram& latency = total.moveLatency;
+        std::printf("%8d %11.0f %9.0f %10.1f %10.1f %10.1f %10.1f", clientCount, movesPerSecond,
+                    static_cast<double>(total.games) / seconds, toMicros(latency.percentile(50.0)),
+                    toMicros(latency.percentile(99.0)), toMicros(latency.percentile(99.9)), toMicros(latency.max()));
+        if (options.aiOpponent) {
+            std::printf(" %10.1f\n", toMicros(total.aiLatency.percentile(99.0)));
+        } else {
+            std::printf(" %10s\n", "-");
+        }
+        if (total.errors > 0 || total.disconnects > 0) {
+            std::printf("%8s %llu errors, %llu disconnects\n", "", static_cast<unsigned long long>(total.errors),
+                        static_cast<unsigned long long>(total.disconnects));
+        }
+        last = total;
+    }
+
+    if (options.clientCounts.size() == 1) {
+        printHistogram("move", last.moveLatency);
+        printHistogram("AI reply", last.aiLatency);
+    } else {
+        // Saturation: the fewest clients that already get 95% of the best throughput
+        for (std::size_t i = 0; i < throughputs.size(); i++) {
+            if (throughputs[i] >= 0.95 * bestThroughput) {
+                std::printf("Throughput saturates at about %d clients (%.0f moves/s)\n", options.clientCounts[i],
+                            throughputs[i]);
+                break;
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,391 @@
+#include "Board.h"
+#include "EngineSpec.h"
+#include "GameRecord.h"
+#include "OpeningBook.h"
+#include "ThreadPool.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+
+/**
+ * Headless AI-vs-AI tournament
+ * Plays games between two engine configurations on a thread pool and reports
+ * the first engine's win, draw and loss rates with 95% confidence intervals.
+ *
+ * Games come in pairs: both games of a pair start from the same random
+ * opening, with the engines swapping colors, so neither engine profits from
+ * a lucky opening or from moving first.
+ *
+ * Every game depends only on --seed and its pair number: the engines start
+ * each game with cleared tables and reseeded random choices, so the results
+ * don't change with the thread count. Time budgets (--movetime) give that up,
+ * and the record file lists games in the order they finish.
+ *
+ * Usage: connect4_selfplay --engine1 SPEC --engine2 SPEC [options]
+ *   --games N          Number of games, rounded up to an even number (default 1000)
+ *   --threads N        Worker threads (default: one per hardware thread)
+ *   --opening-plies N  Random moves played before the engines take over (default 2)
+ *   --movetime MS      Time budget per move in milliseconds (default: fixed depth)
+ *   --tt MB            Transposition table size per engine (default 4)
+ *   --book FILE        Opening book for both engines (standard board only)
+ *   --seed N           Seed for openings and random engines (default 1)
+ *   --variant V        Board: 7x6 (default), 8x7, 9x7 or 9x6c5 (connect five)
+ *   --record FILE      Save every game to a game record file (see GameRecord.h)
+ * Engine specs: random, minimax[:depth], solver
+ */
+
+namespace {
+
+struct Options {
+    EngineSpec engines[2];
+    std::uint64_t games = 1000;
+    int threads = 0;
+    int openingPlies = 2;
+    std::int64_t moveTimeMs = 0;
+    std::size_t ttSizeMB = 4;
+    std::string bookPath;
+    std::uint32_t seed = 1;
+    std::string variant = "7x6";
+    std::string recordPath;
+};
+
+// Tournament totals from the first engine's point of view
+struct Results {
+    std::atomic<std::uint64_t> wins{0};
+    std::atomic<std::uint64_t> draws{0};
+    std::atomic<std::uint64_t> losses{0};
+    std::atomic<std::uint64_t> failed{0};
+    std::atomic<std::uint64_t> moves{0};
+
+    std::uint64_t played() const {
+        return wins.load() + draws.load() + losses.load();
+    }
+};
+
+// Game record file shared by all workers
+struct Recorder {
+    GameRecordWriter writer;
+    std::mutex mutex;
+};
+
+template <typename BoardT>
+char playerToMove(const BoardT& board) {
+    return (board.getMoveCount() % 2 == 0) ? 'X' : 'O';
+}
+
+/**
+ * Plays random moves that don't end the game
+ */
+template <typename BoardT>
+void playRandomOpening(BoardT& board, int plies, std::mt19937& rng) {
+    for (int ply = 0; ply < plies; ply++) {
+        int candidates[BoardT::COLS];
+        int count = 0;
+        for (int col = 0; col < BoardT::COLS; col++) {
+            typename BoardT::MoveGuard move(board, col, playerToMove(board));
+            if (move.applied() && !board.lastMoveWins() && !board.isFull()) {
+                candidates[count++] = col;
+            }
+        }
+        if (count == 0) {
+            return;
+        }
+
+        std::uniform_int_distribution<int> pick(0, count - 1);
+        board.dropPiece(candidates[pick(rng)], playerToMove(board));
+    }
+}
+
+/**
+ * Plays one game to the end
+ * @param board Starting position; receives the final position
+ * @param players AI for 'X' and for 'O'
+ * @return 'X' or 'O' for the winner, ' ' for a draw, '?' if an engine failed
+ */
+template <typename BoardT>
+char playGame(BoardT& board, BasicAIPlayer<BoardT>* players[2], const SearchLimits& limits, std::uint64_t& moves) {
+    while (true) {
+        char player = playerToMove(board);
+        int column = players[player == 'X' ? 0 : 1]->selectMove(board, limits);
+        if (!board.dropPiece(column, player)) {
+            return '?';
+        }
+        moves++;
+
+        if (board.lastMoveWins()) {
+            return player;
+        }
+        if (board.isFull()) {
+            return ' ';
+        }
+    }
+}
+
+/**
+ * Worker: keeps its own engines (one per engine and color, so their tables
+ * are allocated once) and plays game pairs until none are left
+ */
+template <typename BoardT>
+void runWorker(const Options& options, std::shared_ptr<const OpeningBook> book,
+               std::atomic<std::uint64_t>& nextPair, Results& results, Recorder* recorder) {
+    std::unique_ptr<BasicAIPlayer<BoardT>> engines[2][2];
+    for (int e = 0; e < 2; e++) {
+        for (int color = 0; color < 2; color++) {
+            engines[e][color] = options.engines[e].create<BoardT>(color == 0 ? 'X' : 'O', options.ttSizeMB, options.seed);
+            engines[e][color]->setOpeningBook(book);
+        }
+    }
+
+    SearchLimits limits;
+    if (options.moveTimeMs > 0) {
+        limits = SearchLimits::timeBudget(options.moveTimeMs);
+    }
+
+    std::uint64_t pairCount = (options.games + 1) / 2;
+    while (true) {
+        std::uint64_t pair = nextPair.fetch_add(1);
+        if (pair >= pairCount) {
+            return;
+        }
+
+        // The opening depends only on the seed and the pair number
+        std::mt19937 rng(options.seed ^ static_cast<std::uint32_t>(pair * 2654435761u));
+        BoardT opening;
+        playRandomOpening(opening, options.openingPlies, rng);
+
+        // The first engine plays 'X' in the first game of the pair
+        for (int xEngine = 0; xEngine < 2; xEngine++) {
+            BasicAIPlayer<BoardT>* players[2] = {engines[xEngine][0].get(), engines[1 - xEngine][1].get()};
+            for (int color = 0; color < 2; color++) {
+                std::uint32_t game = static_cast<std::uint32_t>(pair * 2 + xEngine);
+                players[color]->newGame(options.seed * 7919u + game * 2654435761u + static_cast<std::uint32_t>(color));
+            }
+
+            BoardT board = opening;
+            std::uint64_t moves = 0;
+            char winner = playGame(board, players, limits, moves);
+            results.moves += moves;
+            if (recorder) {
+                std::lock_guard<std::mutex> lock(recorder->mutex);
+                recorder->writer.write(board, winner);
+            }
+
+            if (winner == '?') {
+                results.failed++;
+                continue;
+            }
+
+            char firstEngineColor = (xEngine == 0) ? 'X' : 'O';
+            if (winner == ' ') {
+                results.draws++;
+            } else if (winner == firstEngineColor) {
+                results.wins++;
+            } else {
+                results.losses++;
+            }
+        }
+    }
+}
+
+using WorkerFunction = void (*)(const Options&, std::shared_ptr<const OpeningBook>,
+                                std::atomic<std::uint64_t>&, Results&, Recorder*);
+
+// A board variant selectable with --variant
+struct Variant {
+    const char* name;
+    int rows;
+    int cols;
+    int connect;
+    WorkerFunction worker;
+};
+
+template <typename BoardT>
+Variant makeVariant(const char* name) {
+    return Variant{name, BoardT::ROWS, BoardT::COLS, BoardT::CONNECT, runWorker<BoardT>};
+}
+
+/**
+ * @return The variant for a --variant name, or nullptr if there is no such variant
+ */
+const Variant* findVariant(const std::string& name) {
+    static const Variant variants[] = {
+        makeVariant<Board>("7x6"),
+        makeVariant<Board8x7>("8x7"),
+        makeVariant<Board9x7>("9x7"),
+        makeVariant<Board9x6Connect5>("9x6c5")
+    };
+    for (const Variant& variant : variants) {
+        if (name == variant.name) {
+            return &variant;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * Wilson score interval for a binomial proportion at 95% confidence
+ */
+void wilsonInterval(std::uint64_t successes, std::uint64_t trials, double& low, double& high) {
+    if (trials == 0) {
+        low = 0.0;
+        high = 1.0;
+        return;
+    }
+
+    const double z = 1.959964;
+    double n = static_cast<double>(trials);
+    double p = static_cast<double>(successes) / n;
+    double denominator = 1.0 + z * z / n;
+    double center = (p + z * z / (2.0 * n)) / denominator;
+    double margin = z * std::sqrt(p * (1.0 - p) / n + z * z / (4.0 * n * n)) / denominator;
+    low = center - margin;
+    high = center + margin;
+}
+
+void printRate(const char* label, std::uint64_t count, std::uint64_t total) {
+    double low, high;
+    wilsonInterval(count, total, low, high);
+    double rate = total > 0 ? 100.0 * static_cast<double>(count) / static_cast<double>(total) : 0.0;
+    std::printf("  %-8s %10llu  %6.2f%%  [%6.2f%%, %6.2f%%]\n", label,
+                static_cast<unsigned long long>(count), rate, 100.0 * low, 100.0 * high);
+}
+
+void printUsage() {
+    std::cerr << "Usage: connect4_selfplay --engine1 SPEC --engine2 SPEC [--games N] [--threads N]\n"
+                 "       [--opening-plies N] [--movetime MS] [--tt MB] [--book FILE] [--seed N]\n"
+                 "       [--variant 7x6|8x7|9x7|9x6c5] [--record FILE]\n"
+                 "Engine specs: random, minimax[:depth], solver\n";
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    bool haveEngine[2] = {false, false};
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            return false;
+        }
+        std::string value = argv[++i];
+
+        if (arg == "--engine1" || arg == "--engine2") {
+            int e = (arg == "--engine1") ? 0 : 1;
+            if (!EngineSpec::parse(value, options.engines[e])) {
+                std::cerr << "Unknown engine spec: " << value << "\n";
+                return false;
+            }
+            haveEngine[e] = true;
+        } else if (arg == "--games") {
+            options.games = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (arg == "--threads") {
+            options.threads = std::atoi(value.c_str());
+        } else if (arg == "--opening-plies") {
+            options.openingPlies = std::atoi(value.c_str());
+        } else if (arg == "--movetime") {
+            options.moveTimeMs = std::atoll(value.c_str());
+        } else if (arg == "--tt") {
+            options.ttSizeMB = static_cast<std::size_t>(std::atoi(value.c_str()));
+        } else if (arg == "--book") {
+            options.bookPath = value;
+        } else if (arg == "--seed") {
+            options.seed = static_cast<std::uint32_t>(std::strtoul(value.c_str(), nullptr, 10));
+        } else if (arg == "--variant") {
+            if (!findVariant(value)) {
+                std::cerr << "Unknown board variant: " << value << "\n";
+                return false;
+            }
+            options.variant = value;
+        } else if (arg == "--record") {
+            options.recordPath = value;
+        } else {
+            return false;
+        }
+    }
+    return haveEngine[0] && haveEngine[1] && options.games > 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 1;
+    }
+
+    std::shared_ptr<OpeningBook> book;
+    if (!options.bookPath.empty() && options.variant != "7x6") {
+        std::cerr << "Opening books only cover the standard 7x6 board\n";
+        return 1;
+    }
+    if (!options.bookPath.empty()) {
+        book = std::make_shared<OpeningBook>();
+        if (!book->open(options.bookPath)) {
+            std::cerr << "Failed to open opening book: " << options.bookPath << "\n";
+            return 1;
+        }
+    }
+
+    const Variant& variant = *findVariant(options.variant);
+    std::unique_ptr<Recorder> recorder;
+    if (!options.recordPath.empty()) {
+        recorder = std::make_unique<Recorder>();
+        if (!recorder->writer.open(options.recordPath, variant.rows, variant.cols, variant.connect)) {
+            std::cerr << "Failed to create game record file: " << options.recordPath << "\n";
+            return 1;
+        }
+    }
+
+    ThreadPool pool(options.threads);
+    std::atomic<std::uint64_t> nextPair(0);
+    Results results;
+    std::uint64_t totalGames = (options.games + 1) / 2 * 2;
+
+    WorkerFunction worker = variant.worker;
+    Recorder* sharedRecorder = recorder.get();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < pool.size(); i++) {
+        pool.submit([&options, worker, book, &nextPair, &results, sharedRecorder]() {
+            worker(options, book, nextPair, results, sharedRecorder);
+        });
+    }
+
+    // Progress report while the pool works
+    while (results.played() + results.failed < totalGames) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        std::cerr << "\r" << results.played() << " / " << totalGames << " games" << std::flush;
+    }
+    pool.wait();
+    std::cerr << "\n";
+    if (recorder && !recorder->writer.close()) {
+        std::cerr << "Failed to write game record file: " << options.recordPath << "\n";
+        return 1;
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::uint64_t played = results.played();
+    double score = played > 0 ? (results.wins + 0.5 * results.draws) / static_cast<double>(played) : 0.0;
+
+    std::printf("%s vs %s: %llu games in %.2f s (%.0f games/s, %.1f moves/game, %d threads)\n",
+                options.engines[0].toString().c_str(), options.engines[1].toString().c_str(),
+                static_cast<unsigned long long>(played), seconds, played / seconds,
+                played > 0 ? static_cast<double>(results.moves) / played : 0.0, pool.size());
+    std::printf("  %-8s %10s  %7s  %s\n", "", "games", "rate", "95% CI");
+    printRate("wins", results.wins, played);
+    printRate("draws", results.draws, played);
+    printRate("losses", results.losses, played);
+    std::printf("  score    %.2f%% for %s\n", 100.0 * score, options.engines[0].toString().c_str());
+    if (results.failed > 0) {
+        std::printf("  %llu games discarded after an illegal move\n",
+                    static_cast<unsigned long long>(results.failed.load()));
+        return 1;
+    }
+    return 0;
+}
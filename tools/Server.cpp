@@ -0,0 +1,576 @@
+#include "GameServer.h"
+#include "WireProtocol.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <string>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+/**
+ * LAN multiplayer server (Linux only)
+ * Hosts games for any number of TCP clients on one thread: an edge-triggered
+ * epoll loop reads every ready socket to exhaustion, answers all complete
+ * requests into per-connection output buffers, and only then writes each
+ * buffer once, so a client that pipelines requests gets its replies in one
+ * send. AI moves come from the GameServer workers, which wake the loop
+ * through an eventfd. The protocol is described in WireProtocol.h.
+ *
+ * A client may run many games at once; its games are closed when it
+ * disconnects.
+ *
+ * Usage: connect4_server [options]
+ *   --port N          TCP port (default 4444)
+ *   --bind ADDR       IPv4 address to listen on (default 0.0.0.0)
+ *   --max-sessions N  Games hosted at once (default 16384)
+ *   --threads N       AI worker threads (default: one per hardware thread)
+ *   --max-depth N     Deepest search a client may ask for, solver included (default 8)
+ *   --movetime MS     Time budget per AI move in milliseconds (default: none)
+ *   --tt MB           Transposition table size per engine (default 4)
+ *   --allow-solver    Let clients play against SolverAI (refused by default)
+ */
+
+namespace {
+
+struct Options {
+    int port = 4444;
+    std::string bindAddress = "0.0.0.0";
+    std::size_t maxSessions = 16384;
+    int threads = 0;
+    int maxDepth = 8;
+    std::int64_t moveTimeMs = 0;
+    std::size_t ttSizeMB = 4;
+    bool allowSolver = false;
+};
+
+// A client whose unsent replies grow past this isn't reading and is dropped
+const std::size_t MAX_PENDING_OUTPUT = 1 << 20;
+
+const int MAX_EVENTS = 256;
+const std::size_t READ_CHUNK = 1 << 16;
+
+std::atomic<bool> interrupted(false);
+
+void onSignal(int) {
+    interrupted = true;
+}
+
+struct Connection {
+    int fd = -1;
+    std::vector<unsigned char> input;
+    std::vector<unsigned char> output;
+    std::size_t outputSent = 0;
+    std::vector<SessionHandle> sessions; // Games opened by this client
+    bool writable = true;                // No EAGAIN since the last EPOLLOUT
+    bool dirty = false;                  // Queued for a flush this iteration
+    bool closing = false;                // Closed at the end of this iteration
+};
+
+struct Totals {
+    std::uint64_t connections = 0;
+    std::uint64_t games = 0;
+    std::uint64_t requests = 0;
+    std::uint64_t aiMoves = 0;
+};
+
+class EventLoop {
+public:
+    EventLoop(const Options& options, GameServer& server)
+        : options(options), server(server), epollFd(-1), listenFd(-1), wakeFd(-1),
+          wakePending(false), sessionOwner(options.maxSessions, -1) {}
+
+    ~EventLoop() {
+        for (std::unique_ptr<Connection>& connection : connections) {
+            if (connection) {
+                ::close(connection->fd);
+            }
+        }
+        for (int fd : {listenFd, wakeFd, epollFd}) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+        }
+    }
+
+    bool start() {
+        epollFd = epoll_create1(EPOLL_CLOEXEC);
+        wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        listenFd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (epollFd < 0 || wakeFd < 0 || listenFd < 0) {
+            std::perror("connect4_server");
+            return false;
+        }
+
+        int reuse = 1;
+        setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(static_cast<std::uint16_t>(options.port));
+        if (inet_pton(AF_INET, options.bindAddress.c_str(), &address.sin_addr) != 1) {
+            std::cerr << "Invalid bind address: " << options.bindAddress << "\n";
+            return false;
+        }
+        if (bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+            listen(listenFd, SOMAXCONN) < 0) {
+            std::perror("connect4_server: listen");
+            return false;
+        }
+
+        if (!watch(listenFd, EPOLLIN | EPOLLET) || !watch(wakeFd, EPOLLIN | EPOLLET)) {
+            return false;
+        }
+
+        // Workers only knock when the loop hasn't been woken yet
+        server.setAIMoveNotifier([this]() {
+            if (!wakePending.exchange(true)) {
+                std::uint64_t one = 1;
+                ssize_t written = ::write(wakeFd, &one, sizeof(one));
+                (void)written;
+            }
+        });
+        return true;
+    }
+
+    void run() {
+        epoll_event events[MAX_EVENTS];
+        while (!interrupted) {
+            int count = epoll_wait(epollFd, events, MAX_EVENTS, -1);
+            if (count < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                std::perror("connect4_server: epoll_wait");
+                return;
+            }
+
+            bool aiMovesReady = false;
+            for (int i = 0; i < count; i++) {
+                int fd = events[i].data.fd;
+                if (fd == listenFd) {
+                    acceptClients();
+                } else if (fd == wakeFd) {
+                    aiMovesReady = true;
+                } else {
+                    serviceClient(*connections[fd], events[i].events);
+                }
+            }
+            if (aiMovesReady) {
+                deliverAIMoves();
+            }
+
+            // One write per client per iteration, however many replies it got
+            // (closing clients too, so replies to their last requests go out)
+            for (Connection* connection : dirty) {
+                connection->dirty = false;
+                if (!flush(*connection)) {
+                    markClosing(*connection);
+                }
+            }
+            dirty.clear();
+
+            // Closing is deferred so a reused descriptor can't pick up an
+            // event meant for the old connection in the same batch
+            for (Connection* connection : closing) {
+                disconnect(connection->fd);
+            }
+            closing.clear();
+        }
+    }
+
+    const Totals& getTotals() const {
+        return totals;
+    }
+
+private:
+    const Options& options;
+    GameServer& server;
+    int epollFd;
+    int listenFd;
+    int wakeFd;
+    std::atomic<bool> wakePending;
+
+    std::vector<std::unique_ptr<Connection>> connections; // Indexed by descriptor
+    std::vector<int> sessionOwner;                        // Descriptor by session slot, -1 if none
+    std::vector<Connection*> dirty;
+    std::vector<Connection*> closing;
+    std::vector<GameServer::AIMove> aiMoves;
+    unsigned char readBuffer[READ_CHUNK];
+    Totals totals;
+
+    bool watch(int fd, std::uint32_t events) {
+        epoll_event event{};
+        event.events = events;
+        event.data.fd = fd;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) < 0) {
+            std::perror("connect4_server: epoll_ctl");
+            return false;
+        }
+        return true;
+    }
+
+    void acceptClients() {
+        while (true) {
+            int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) {
+                if (errno == EINTR || errno == ECONNABORTED) {
+                    continue;
+                }
+                if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                    std::perror("connect4_server: accept");
+                }
+                return;
+            }
+
+            int noDelay = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+            if (!watch(fd, EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET)) {
+                ::close(fd);
+                continue;
+            }
+
+            if (static_cast<std::size_t>(fd) >= connections.size()) {
+                connections.resize(fd + 1);
+            }
+            connections[fd] = std::make_unique<Connection>();
+            connections[fd]->fd = fd;
+            totals.connections++;
+        }
+    }
+
+    void serviceClient(Connection& connection, std::uint32_t events) {
+        if (connection.closing) {
+            return;
+        }
+        if (events & EPOLLOUT) {
+            connection.writable = true;
+            markDirty(connection);
+        }
+        if (events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+            if (!receive(connection)) {
+                markClosing(connection);
+            }
+        }
+    }
+
+    // Reads until the socket is drained, as edge triggering requires, and
+    // answers every complete request
+    bool receive(Connection& connection) {
+        bool open = true;
+        while (true) {
+            ssize_t received = recv(connection.fd, readBuffer, sizeof(readBuffer), 0);
+            if (received > 0) {
+                connection.input.insert(connection.input.end(), readBuffer, readBuffer + received);
+                continue;
+            }
+            if (received < 0 && errno == EINTR) {
+                continue;
+            }
+            // Requests that arrived with the end of the stream are still answered
+            open = received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+            break;
+        }
+
+        std::size_t offset = 0;
+        WireMessage request;
+        while (true) {
+            std::size_t consumed = 0;
+            DecodeStatus status = WireProtocol::decode(connection.input.data() + offset,
+                                                       connection.input.size() - offset, request, consumed);
+            if (status == DecodeStatus::MALFORMED) {
+                return false;
+            }
+            if (status == DecodeStatus::INCOMPLETE) {
+                break;
+            }
+            offset += consumed;
+            totals.requests++;
+            handle(connection, request);
+        }
+        connection.input.erase(connection.input.begin(), connection.input.begin() + offset);
+        return open;
+    }
+
+    void handle(Connection& connection, const WireMessage& request) {
+        switch (request.type) {
+            case MessageType::NEW_GAME:
+                newGame(connection, request);
+                break;
+            case MessageType::MOVE: {
+                SessionHandle session = SessionHandle::fromId(request.session);
+                if (!owns(connection, session)) {
+                    sendError(connection, request, WireError::UNKNOWN_SESSION);
+                } else if (!server.makeMove(session, request.column)) {
+                    sendError(connection, request, WireError::ILLEGAL_MOVE);
+                } else {
+                    sendState(connection, session);
+                }
+                break;
+            }
+            case MessageType::CLOSE_GAME: {
+                SessionHandle session = SessionHandle::fromId(request.session);
+                if (!owns(connection, session)) {
+                    sendError(connection, request, WireError::UNKNOWN_SESSION);
+                } else {
+                    closeGame(connection, session);
+                }
+                break;
+            }
+            case MessageType::PING: {
+                WireMessage reply;
+                reply.type = MessageType::PONG;
+                reply.token = request.token;
+                send(connection, reply);
+                break;
+            }
+            default:
+                // Server-to-client messages are ignored
+                break;
+        }
+    }
+
+    void newGame(Connection& connection, const WireMessage& request) {
+        if (request.aiPlayer != 'X' && request.aiPlayer != 'O' && request.aiPlayer != ' ') {
+            sendError(connection, request, WireError::BAD_REQUEST);
+            return;
+        }
+
+        // An unbounded solve can hold a worker for hours, so the solver must
+        // be enabled explicitly, and even then it only looks --max-depth
+        // plies ahead like every other engine (see SolverAI)
+        if (request.engine.kind == EngineSpec::Kind::SOLVER && !options.allowSolver) {
+            sendError(connection, request, WireError::BAD_REQUEST);
+            return;
+        }
+        EngineSpec engine = request.engine;
+        engine.depth = std::max(1, std::min(engine.depth, options.maxDepth));
+        SessionHandle session = server.createSession(engine, request.aiPlayer);
+        if (!session.isValid()) {
+            sendError(connection, request, WireError::SERVER_FULL);
+            return;
+        }
+
+        sessionOwner[session.index] = connection.fd;
+        connection.sessions.push_back(session);
+        totals.games++;
+        sendState(connection, session);
+    }
+
+    bool owns(const Connection& connection, SessionHandle session) const {
+        return session.index < sessionOwner.size() && sessionOwner[session.index] == connection.fd &&
+               server.getSession(session) != nullptr;
+    }
+
+    void closeGame(Connection& connection, SessionHandle session) {
+        server.closeSession(session);
+        sessionOwner[session.index] = -1;
+        std::vector<SessionHandle>& sessions = connection.sessions;
+        auto it = std::find(sessions.begin(), sessions.end(), session);
+        if (it != sessions.end()) {
+            *it = sessions.back();
+            sessions.pop_back();
+        }
+    }
+
+    void deliverAIMoves() {
+        std::uint64_t count = 0;
+        ssize_t drained = ::read(wakeFd, &count, sizeof(count));
+        (void)drained;
+        wakePending = false;
+
+        server.pollAIMoves(aiMoves);
+        for (const GameServer::AIMove& move : aiMoves) {
+            int fd = sessionOwner[move.session.index];
+            if (move.column == GameServer::NO_MOVE) {
+                // The game can't go on, so it is closed rather than left waiting
+                if (fd >= 0) {
+                    failAIMove(*connections[fd], move.session);
+                }
+                continue;
+            }
+            totals.aiMoves++;
+            if (fd >= 0 && !connections[fd]->closing) {
+                sendState(*connections[fd], move.session);
+            }
+        }
+    }
+
+    void failAIMove(Connection& connection, SessionHandle session) {
+        if (!connection.closing) {
+            WireMessage request;
+            request.type = MessageType::MOVE;
+            request.session = session.toId();
+            sendError(connection, request, WireError::AI_FAILED);
+        }
+        closeGame(connection, session);
+    }
+
+    void sendState(Connection& connection, SessionHandle session) {
+        WireMessage reply;
+        WireProtocol::snapshot(server.getSession(session)->state, reply);
+        reply.session = session.toId();
+        send(connection, reply);
+    }
+
+    void sendError(Connection& connection, const WireMessage& request, WireError error) {
+        WireMessage reply;
+        reply.type = MessageType::ERROR;
+        reply.session = request.session;
+        reply.error = error;
+        reply.rejected = request.type;
+        send(connection, reply);
+    }
+
+    void send(Connection& connection, const WireMessage& message) {
+        WireProtocol::encode(message, connection.output);
+        markDirty(connection);
+    }
+
+    // Writes as much pending output as the socket takes
+    bool flush(Connection& connection) {
+        std::vector<unsigned char>& output = connection.output;
+        while (connection.writable && connection.outputSent < output.size()) {
+            ssize_t sent = ::send(connection.fd, output.data() + connection.outputSent,
+                                  output.size() - connection.outputSent, MSG_NOSIGNAL);
+            if (sent > 0) {
+                connection.outputSent += static_cast<std::size_t>(sent);
+            } else if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                connection.writable = false;
+            } else if (sent < 0 && errno == EINTR) {
+                continue;
+            } else {
+                return false;
+            }
+        }
+
+        if (connection.outputSent == output.size()) {
+            output.clear();
+            connection.outputSent = 0;
+        }
+        return output.size() - connection.outputSent <= MAX_PENDING_OUTPUT;
+    }
+
+    void markDirty(Connection& connection) {
+        if (!connection.dirty) {
+            connection.dirty = true;
+            dirty.push_back(&connection);
+        }
+    }
+
+    void markClosing(Connection& connection) {
+        if (!connection.closing) {
+            connection.closing = true;
+            closing.push_back(&connection);
+        }
+    }
+
+    void disconnect(int fd) {
+        Connection& connection = *connections[fd];
+        for (SessionHandle session : connection.sessions) {
+            server.closeSession(session);
+            sessionOwner[session.index] = -1;
+        }
+        ::close(fd); // Also removes it from the epoll set
+        connections[fd].reset();
+    }
+};
+
+void printUsage() {
+    std::cerr << "Usage: connect4_server [--port N] [--bind ADDR] [--max-sessions N] [--threads N]\n"
+                 "       [--max-depth N] [--movetime MS] [--tt MB] [--allow-solver]\n";
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--allow-solver") {
+            options.allowSolver = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            return false;
+        }
+        std::string value = argv[++i];
+
+        if (arg == "--port") {
+            options.port = std::atoi(value.c_str());
+        } else if (arg == "--bind") {
+            options.bindAddress = value;
+        } else if (arg == "--max-sessions") {
+            options.maxSessions = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (arg == "--threads") {
+            options.threads = std::atoi(value.c_str());
+        } else if (arg == "--max-depth") {
+            options.maxDepth = std::atoi(value.c_str());
+        } else if (arg == "--movetime") {
+            options.moveTimeMs = std::atoll(value.c_str());
+        } else if (arg == "--tt") {
+            options.ttSizeMB = static_cast<std::size_t>(std::atoi(value.c_str()));
+        } else {
+            return false;
+        }
+    }
+    return options.port > 0 && options.port < 65536 && options.maxSessions > 0 && options.maxDepth > 0;
+}
+
+// Thousands of clients need more descriptors than the usual soft limit
+void raiseDescriptorLimit() {
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 1;
+    }
+
+    raiseDescriptorLimit();
+    struct sigaction action{};
+    action.sa_handler = onSignal;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+
+    GameServerConfig config;
+    config.maxSessions = options.maxSessions;
+    config.aiThreads = options.threads;
+    config.ttSizeMB = options.ttSizeMB;
+    config.limits.timeMs = options.moveTimeMs;
+    std::unique_ptr<GameServer> server = std::make_unique<GameServer>(config);
+
+    std::unique_ptr<EventLoop> loop = std::make_unique<EventLoop>(options, *server);
+    if (!loop->start()) {
+        return 1;
+    }
+    std::cerr << "Listening on " << options.bindAddress << ":" << options.port << " ("
+              << server->workerCount() << " AI threads, up to " << options.maxSessions << " games)\n";
+    loop->run();
+
+    // The workers must be gone before the loop they notify
+    server.reset();
+
+    const Totals& totals = loop->getTotals();
+    std::printf("%llu connections, %llu games, %llu requests, %llu AI moves\n",
+                static_cast<unsigned long long>(totals.connections), static_cast<unsigned long long>(totals.games),
+                static_cast<unsigned long long>(totals.requests), static_cast<unsigned long long>(totals.aiMoves));
+    return 0;
+}